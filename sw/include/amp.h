@@ -22,6 +22,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include "fp_lib_types.h"
 #include "fp_lib_typeconv.h"
 #include "fp_lib_mul.h"
+#include "fp_lib_trig.h"
 #include "block_len_def.h"
 
 
@@ -68,4 +69,76 @@ inline static void calcAmp(
     
 }
 
+/**
+ * @brief Calculation of constant-power pan gains
+ *
+ * gainL = gain * cos((pan + 1) * pi / 4), gainR = gain * sin((pan + 1) * pi / 4)
+ * @param params Struct holding amplifier parameters
+ * @param gains Gains for left and right stereo channel in Q0.15 format
+ */
+inline static void calcAmpPanGains(
+                                   const AmpParams * const params,
+                                   _Q15 * const gains)
+{
+    // Map pan (-1 ... 1) to phase (0 ... 1/4)
+    const _Q16 phase = ((uint16_t)params->pan ^ 0x8000) >> 2;
+
+    gains[0] = mul_Q15_Q16(sin_Q15(phase + 0x4000), params->gain);
+    gains[1] = mul_Q15_Q16(sin_Q15(phase), params->gain);
+}
+
+/**
+ * @brief Apply VCA and constant-power pan to mono signal and add it to stereo mix bus
+ *
+ * The input is multiplied by the per-sample gain (e.g. envelope) and the pan gains of both stereo channels and
+ * accumulated into the mix bus with saturation within one loop
+ * @param params Struct holding amplifier parameters
+ * @param input Mono input buffer of BLOCK_LEN samples in Q0.15 format
+ * @param gain Per-sample gain buffer of BLOCK_LEN samples in Q0.15 format
+ * @param busLeft Mix bus for left stereo channel
+ * @param busRight Mix bus for right stereo channel
+ */
+inline static void addAmpToBus(
+                               const AmpParams * const params,
+                               const _Q15 * input,
+                               const _Q15 * gain,
+                               _Q15 * busLeft,
+                               _Q15 * busRight)
+{
+    _Q15 gains[2];
+    calcAmpPanGains(
+            params,
+            gains);
+
+    __asm__ volatile(
+            "\
+        mov     %[gainL], w6                                                    ;w6 = pan gain for left channel \n \
+        mov     %[gainR], w7                                                    ;w7 = pan gain for right channel \n \
+                                                                                ;\n \
+    ;Start processing loop                                                      ;\n \
+        do #%[Len]-1, AddAmpToBus_%=                                            ;\n \
+                                                                                ;\n \
+    ;VCA: v = x * gain                                                          ;\n \
+        mov     [%[x]++], w4                                                    ;w4 = x \n \
+        mov     [%[g]++], w5                                                    ;w5 = gain \n \
+        mpy     w4 * w5, A                                                      ;AccA = x * gain \n \
+        sac.r   A, #0, w4                                                       ;w4 = v \n \
+                                                                                ;\n \
+    ;Pan and accumulate: bus += v * pan gain                                    ;\n \
+        lac     [%[bL]], #0, A                                                  ;AccA = left bus \n \
+        lac     [%[bR]], #0, B                                                  ;AccB = right bus \n \
+        mac     w4 * w6, A                                                      ;AccA += v * left pan gain \n \
+        mac     w4 * w7, B                                                      ;AccB += v * right pan gain \n \
+        sac.r   A, #0, [%[bL]++]                                                ;Store AccA in left bus, increment pointer \n \
+                                                                                ;\n \
+    AddAmpToBus_%=:                                                             ;\n \
+        sac.r   B, #0, [%[bR]++]                                                ;Store AccB in right bus, increment pointer \n \
+                                                                                ;\n \
+        ; 4 + 10N cycles total"
+            : [x]"+r"(input), [g]"+r"(gain), [bL]"+r"(busLeft), [bR]"+r"(busRight) /*out*/
+            : [Len]"i"(BLOCK_LEN), [gainL]"r"(gains[0]), [gainR]"r"(gains[1]) /*in*/
+            : "w4", "w5", "w6", "w7" /*clobbered*/
+            );
+}
+
 #endif
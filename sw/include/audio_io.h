@@ -0,0 +1,80 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file audio_io.h
+ * @brief Function prototypes for double-buffered audio I/O
+ * 
+ * Receive and transmit DMA channels of the audio peripheral (DCI or I2S) run in ping-pong mode with interleaved
+ * stereo buffers of AUDIO_IO_BUFFER_LEN words. Both channels are started together, so a block is completed in both
+ * directions at the same time. The DMA interrupt calls handleAudioIOInterrupt(), processAudioIO() renders the
+ * completed block either directly in the interrupt or in the main loop.
+ * 
+ * Render callback contract:
+ * - The callback is called once per block and must return within BLOCK_LEN sample periods (minus the overhead of
+ *   processAudioIO()), otherwise the render is late and the DMA transmits a partially rendered buffer
+ * - The input-to-output latency is 2 * BLOCK_LEN sample periods
+ * - Peripheral and DMA register setup is device specific and done by the caller, the buffer addresses are taken from
+ *   AudioIOState.rxBuffer and AudioIOState.txBuffer
+ * 
+ * audio_io.c is plain C, so the same code can be driven by the host simulation in audio_io_sim.h
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#ifndef AUDIO_IO_H
+#define AUDIO_IO_H
+
+#include "audio_io_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Initialize audio I/O state
+ * @param io Struct holding audio I/O state
+ * @param rxMemory Receive DMA memory of NOF_AUDIO_IO_BUFFERS * AUDIO_IO_BUFFER_LEN words
+ * @param txMemory Transmit DMA memory of NOF_AUDIO_IO_BUFFERS * AUDIO_IO_BUFFER_LEN words, will be cleared
+ * @param render Render callback
+ * @param context Context pointer passed to the render callback
+ */
+void initAudioIO(
+        AudioIOState * const io,
+        _Q15 * const rxMemory,
+        _Q15 * const txMemory,
+        const AudioRenderCallback render,
+        void * const context);
+
+/**
+ * @brief Handle DMA block completion, to be called from the DMA interrupt
+ * @param io Struct holding audio I/O state
+ */
+inline static void handleAudioIOInterrupt(AudioIOState * const io)
+{
+    ++io->completed;
+}
+
+/**
+ * @brief Render the last completed block
+ * 
+ * Blocks which completed while a render was still outstanding are dropped (counted in nofDroppedBlocks)
+ * @param io Struct holding audio I/O state
+ * @return true if a block has been rendered, false if no block was pending
+ */
+bool processAudioIO(AudioIOState * const io);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file audio_io_sim.h
+ * @brief Function prototypes for host simulation of double-buffered audio I/O
+ * 
+ * Host-only stand-in for the DMA and its interrupt (POSIX, not part of the dsPIC build). The simulation drives
+ * handleAudioIOInterrupt() and processAudioIO() from a simulated sample clock, the render time is measured with
+ * CLOCK_MONOTONIC, so render callbacks can be checked for deadline misses in CI (see sim/audio_io_sim_main.c)
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#ifndef AUDIO_IO_SIM_H
+#define AUDIO_IO_SIM_H
+
+#include "audio_io_types.h"
+#include <stdint.h>
+
+/// Audio I/O simulation statistics
+typedef struct
+{
+    /// Number of simulated DMA blocks
+    uint32_t nofBlocks;
+
+    /// Number of renders which finished after the DMA had started to transfer the rendered buffer
+    uint32_t nofLateRenders;
+
+    /// Number of blocks which were not rendered at all
+    uint32_t nofDroppedBlocks;
+
+    /// Block period in ns
+    uint32_t blockPeriod;
+
+    /// Maximum render time in ns (including processAudioIO() overhead)
+    uint32_t maxRenderTime;
+
+    /// Nominal input-to-output latency in ns (NOF_AUDIO_IO_BUFFERS block periods, given by the buffering scheme)
+    uint32_t latency;
+} AudioIOSimStats;
+
+/**
+ * @brief Run audio I/O simulation
+ * 
+ * The receive buffers are not written by the simulation, i.e. the caller may fill them with test input
+ * @param io Struct holding audio I/O state as initialized by initAudioIO()
+ * @param sampleRate Simulated sample rate in Hz
+ * @param nofBlocks Number of blocks to be simulated
+ * @param stats Simulation statistics
+ */
+void runAudioIOSimulation(
+        AudioIOState * const io,
+        const uint32_t sampleRate,
+        const uint32_t nofBlocks,
+        AudioIOSimStats * const stats);
+
+#endif
@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file audio_io_types.h
+ * @brief Type definitions for double-buffered audio I/O
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#ifndef AUDIO_IO_TYPES_H
+#define AUDIO_IO_TYPES_H
+
+#include "fp_lib_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+
+/// Number of DMA buffers per direction (ping-pong)
+#define NOF_AUDIO_IO_BUFFERS 2
+
+/// Length of each DMA buffer in words (interleaved stereo samples)
+#define AUDIO_IO_BUFFER_LEN (2 * BLOCK_LEN)
+
+/**
+ * @brief Render callback
+ * 
+ * Called once per block with the input samples in dataL and dataR, the output samples are written in-place
+ * @param context Caller-supplied context pointer
+ * @param dataL Audio data for left stereo channel (BLOCK_LEN samples)
+ * @param dataR Audio data for right stereo channel (BLOCK_LEN samples)
+ */
+typedef void (*AudioRenderCallback)(
+        void * const context,
+        _Q15 * const dataL,
+        _Q15 * const dataR);
+
+/// Audio I/O state
+typedef struct
+{
+    /// DMA receive buffers (ping-pong)
+    _Q15 * rxBuffer[NOF_AUDIO_IO_BUFFERS];
+
+    /// DMA transmit buffers (ping-pong)
+    _Q15 * txBuffer[NOF_AUDIO_IO_BUFFERS];
+
+    /// Render callback
+    AudioRenderCallback render;
+
+    /// Context pointer passed to the render callback
+    void * context;
+
+    /// Audio data for left stereo channel passed to the render callback
+    _Q15 dataL[BLOCK_LEN];
+
+    /// Audio data for right stereo channel passed to the render callback
+    _Q15 dataR[BLOCK_LEN];
+
+    /// Number of completed DMA blocks (only written by handleAudioIOInterrupt())
+    volatile uint16_t completed;
+
+    /// Number of rendered or dropped blocks (only written by processAudioIO())
+    uint16_t rendered;
+
+    /// Number of renders which finished after the DMA had started to transfer the rendered buffer
+    uint16_t nofLateRenders;
+
+    /// Number of blocks which were not rendered at all
+    uint16_t nofDroppedBlocks;
+} AudioIOState;
+
+#endif
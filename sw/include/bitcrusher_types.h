@@ -44,10 +44,10 @@ typedef struct
 /// Bitcrusher parameters
 typedef struct
 {
-    /// Bitcrusher sample rate
+    /// Bitcrusher sample rate relative to audio sample rate (0 = lowest ... 1 = full sample rate)
     _Q16 sampleRate;
     
-    /// Bitcrusher quantization
+    /// Bitcrusher quantization (0 = full resolution ... 1 = 1 bit)
     _Q16 quantization;
         
     /// Bitcrusher mix
@@ -0,0 +1,51 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file env_adsr_bank.h
+ * @brief Function prototypes for ADSR envelope bank calculation
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef ENV_ADSR_BANK_H
+#define	ENV_ADSR_BANK_H
+
+#include "env_adsr_bank_types.h"
+#include "env_adsr_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Update all envelopes of an ADSR envelope bank
+ * 
+ * All envelopes share the same envelope parameters and behave like updateEnvADSR(). Stage transitions are
+ * calculated for all envelopes at once by bitmask operations, the decay factors are looked up once per stage
+ * and each stage is processed by its own loop. Idle envelopes are skipped entirely
+ * @note A zero-initialized bank is valid, all envelopes are idle
+ * @param params Struct holding ADSR envelope parameters
+ * @param gates Flags indicating the gate is open, bit n for envelope n
+ * @param triggers Flags indicating the envelope has been (re-)triggered, bit n for envelope n
+ * @param bank Struct holding ADSR envelope bank state, the envelope values in Q0.16 format are updated in bank->value[]
+ */
+void updateEnvADSRBank(
+        const ADSRParams * params,
+        uint16_t gates,
+        uint16_t triggers,
+        ADSRBank * bank);
+
+#endif
@@ -0,0 +1,58 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file env_adsr_bank_types.h
+ * @brief Definition of ADSR envelope bank types
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef ENV_ADSR_BANK_TYPES_H
+#define	ENV_ADSR_BANK_TYPES_H
+
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/// Number of envelopes in an ADSR envelope bank (one bit per envelope in the stage masks)
+#define NOF_ADSR_BANK_ENVS 16
+
+/// Envelope value below which a releasing envelope is set to zero and becomes idle (~ -72 dB)
+#define ADSR_BANK_IDLE_THRESHOLD 16
+
+/**
+ * ADSR envelope bank state
+ *
+ * The envelope values are stored as array, the stages are stored as one bitmask per stage, bit n representing
+ * envelope n. Envelopes which are in none of the stage masks are idle, i.e. released to zero
+ */
+typedef struct
+{
+    /// Current envelope values
+    _Q16 value[NOF_ADSR_BANK_ENVS];
+
+    /// Envelopes in attack stage
+    uint16_t attack;
+
+    /// Envelopes in decay stage
+    uint16_t decay;
+
+    /// Envelopes in release stage which have not yet decayed to zero
+    uint16_t release;
+} ADSRBank;
+
+#endif
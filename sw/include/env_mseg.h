@@ -0,0 +1,81 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file env_mseg.h
+ * @brief Function prototypes for multi-segment envelope calculation
+ * 
+ * A multi-segment envelope runs through a list of segments with target level, time and curve shape, e.g. a DAHDSR
+ * envelope is given by the segments delay (hold at 0), attack (linear to 1), hold (hold at 1), decay (exponential to
+ * sustain level, sustain segment) and release (exponential to 0, release segment).
+ * The segment parameters are shared by all voices, the per-voice state is a small struct, so 16 voices with
+ * 3 envelopes each cost 48 * (~40 + 2 + 3 * BLOCK_LEN) cycles per block (approximate).
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef ENV_MSEG_H
+#define	ENV_MSEG_H
+
+#include "env_mseg_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Calculate multi-segment envelope parameters
+ * 
+ * Look up the per-update coefficient of each segment, call this function whenever a segment has changed
+ * @param params Struct holding multi-segment envelope parameters
+ */
+void calcEnvMSEGParams(MSEGParams * params);
+
+/**
+ * @brief Update multi-segment envelope
+ * 
+ * Update the envelope state from envelope parameters and return the output value calculated from the updated state
+ * @note This envelope is retriggerable, a retriggered envelope starts from its current value
+ * @param params Struct holding multi-segment envelope parameters
+ * @param gate Flag indicating the gate is open
+ * @param trigger Flag indicating the envelope has been (re-)triggered
+ * @param state Struct holding multi-segment envelope state
+ * @return Envelope output value in Q0.16 format
+ */
+_Q16 updateEnvMSEG(
+        const MSEGParams * params,
+        bool gate,
+        bool trigger,
+        MSEGState * state);
+
+/**
+ * @brief Update multi-segment envelope for one block of samples
+ * 
+ * Update the envelope state once like updateEnvMSEG() and write a linear ramp from the previous to the updated value
+ * @param params Struct holding multi-segment envelope parameters
+ * @param gate Flag indicating the gate is open
+ * @param trigger Flag indicating the envelope has been (re-)triggered
+ * @param state Struct holding multi-segment envelope state
+ * @param data Buffer of BLOCK_LEN samples to be filled with envelope values in Q0.16 format
+ */
+void updateEnvMSEGBlock(
+        const MSEGParams * params,
+        bool gate,
+        bool trigger,
+        MSEGState * state,
+        _Q16 * data);
+
+#endif
@@ -0,0 +1,96 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file env_mseg_types.h
+ * @brief Definition of multi-segment envelope related types
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef ENV_MSEG_TYPES_H
+#define	ENV_MSEG_TYPES_H
+
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/// Maximum number of segments of a multi-segment envelope
+#define NOF_MSEG_SEGMENTS 8
+
+/// Segment index indicating that the envelope has no sustain segment
+#define MSEG_NO_SUSTAIN 0xFFFF
+
+/// Difference to the target level below which an exponential segment has settled (~ -60 dB)
+#define MSEG_SETTLE_THRESHOLD 64
+
+/// Curve shape of an envelope segment
+typedef enum
+{
+    MSEG_CURVE_LINEAR = 0, // Linear ramp to target level within segment time (time from linear rate table)
+    MSEG_CURVE_EXP,        // Exponential approach to target level (time from expDecayTable, ends when settled)
+    MSEG_CURVE_HOLD        // Jump to target level and hold it for segment time, e.g. delay or hold segment
+} MSEGCurve;
+
+/// Envelope segment
+typedef struct
+{
+    /// Target level at the end of the segment
+    _Q16 level;
+
+    /// Segment time 0..255
+    uint8_t time;
+
+    /// Curve shape
+    MSEGCurve curve;
+} MSEGSegment;
+
+/// Multi-segment envelope parameters
+typedef struct
+{
+    /// Envelope segments
+    MSEGSegment segment[NOF_MSEG_SEGMENTS];
+
+    /// Per-update coefficient of each segment, calculated by calcEnvMSEGParams()
+    _Q16 coeff[NOF_MSEG_SEGMENTS];
+
+    /// Number of segments
+    uint16_t nofSegments;
+
+    /// Segment whose target level is held while the gate is open or MSEG_NO_SUSTAIN
+    uint16_t sustainSegment;
+
+    /// First segment after the gate has been closed
+    uint16_t releaseSegment;
+} MSEGParams;
+
+/// Multi-segment envelope state
+typedef struct
+{
+    /// Current envelope value
+    _Q16 value;
+
+    /// Envelope value at the start of the current segment
+    _Q16 start;
+
+    /// Progress within the current linear or hold segment in Q0.16 format
+    _Q16 progress;
+
+    /// Current segment, nofSegments if the envelope has finished
+    uint16_t segment;
+} MSEGState;
+
+#endif
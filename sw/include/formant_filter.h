@@ -1,81 +1,69 @@
-#ifndef FORMANT_FILTER_H
-#define	FORMANT_FILTER_H
-
-#include <stdint.h>
-#include "fp_lib_typeconv.h"
-
-#define NOF_VOWELS_POW2 2
-
-#define NOF_VOWELS ((1 << NOF_VOWELS_POW2) + 1)
+/*
+Copyright (C) 2022 Andreas Lagler
 
-#define NOF_FORMANT_FILTER_STAGES 4
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
 
-static inline int16_t calcLinearInterpolation(
-                                              const _Q15 y1,
-                                              const _Q15 y2,
-                                              const _Q15 x)
-{
-    _Q15 y = 0;
-    __asm__ volatile(
-            "\
-        lac     %[Y1], #0, A                                                       ;AccA = X1[k] \n \
-        msc     %[Y1] * %[X], A                                                  ;AccA -= X1[k] * Mix => AccA = X1[k] * (1-Mix) \n \
-        mac     %[Y2] * %[X], A                                                  ;AccA += X2[k] * Mix => AccA = X1[k] * (1-Mix) + X2[k] * Mix \n \
-        sac.r   A, #0, %[Y]                                                ;X2[k] = AccB \n \
-                                                                                ;\n \
-        ; 4 cycles total"
-            : [Y]"+r"(y) /*out*/
-            : [Y1]"z"(y1), [Y2]"z"(y2), [X]"z"(x) /*in*/
-            : /*clobbered*/
-            );
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
 
-    return y;
-}
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
 
-static inline int16_t calcFreq(
-                               const uint16_t stage,
-                               const _Q16 shape)
-{
-    static const int16_t freqTable[NOF_VOWELS][NOF_FORMANT_FILTER_STAGES] = {
-        {15647, 17236, 19944, 21248},
-        {14021, 19096, 20065, 20854},
-        {12321, 19498, 20656, 21248},
-        {14014, 15787, 20025, 20757},
-        {12610, 17328, 19772, 20886}
-    };
+/**
+ * @file formant_filter.h
+ * @brief Function prototypes for formant filter
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
 
-    const uint16_t shapeInt = shape >> (16 - NOF_VOWELS_POW2);
-    const _Q15 shapeFract = convert_Q16_Q15(shape << NOF_VOWELS_POW2);
-    const _Q15 freq = calcLinearInterpolation(
-                                              freqTable[shapeInt][stage],
-                                              freqTable[shapeInt + 1][stage],
-                                              shapeFract);
-
-    return freq;
-}
-
-//
+#ifndef FORMANT_FILTER_H
+#define	FORMANT_FILTER_H
 
-static inline _Q16 calcResonance(
-                                 const uint16_t stage,
-                                 const _Q16 shape)
-{
-    static const _Q15 resonanceTable[NOF_VOWELS][NOF_FORMANT_FILTER_STAGES] = {
-        {30798, 31248, 31694, 31684},
-        {29609, 31880, 31731, 31554},
-        {27566, 31978, 31894, 31684},
-        {29603, 30455, 31719, 31519},
-        {27992, 31288, 31639, 31565}
-    };
+#include "fp_lib_types.h"
+#include "formant_filter_types.h"
 
-    const uint16_t shapeInt = shape >> (16 - NOF_VOWELS_POW2);
-    const _Q15 shapeFract = convert_Q16_Q15(shape << NOF_VOWELS_POW2);
-    const _Q15 resonance = calcLinearInterpolation(
-                                                   resonanceTable[shapeInt][stage],
-                                                   resonanceTable[shapeInt + 1][stage],
-                                                   shapeFract);
+/**
+ * @brief In-place calculation of cascaded formant filter
+ *
+ * NOF_FORMANT_FILTER_STAGES SVF lowpass stages tuned to the formants of the selected vowel are processed per sample
+ * within one loop. Filter coefficients are interpolated between the neighboring vowels once per block
+ * @param vowel Vowel selection in Q0.16 format (0 = first vowel ... 1 = last vowel)
+ * @param state Struct holding formant filter state
+ * @param xBuffer Work buffer of size >= 2 * NOF_FORMANT_FILTER_STAGES allocated in x memory
+ * @param yBuffer Work buffer of size >= 3 * NOF_FORMANT_FILTER_STAGES allocated in y memory
+ * @param data Buffer of BLOCK_LEN samples to be filtered allocated in x memory
+ */
+void calcFormantFilterBlockInplace(
+        const _Q16 vowel,
+        FormantFilterState * const state,
+        _Q15 * const xBuffer,
+        _Q15 * const yBuffer,
+        _Q15 * const data);
 
-    return convert_Q15_Q16_Naive(resonance);
-}
+/**
+ * @brief In-place calculation of parallel formant filter
+ *
+ * NOF_FORMANT_FILTER_STAGES SVF bandpass filters tuned to the formants of the selected vowel are fed from the same input
+ * sample and summed with per-formant gains within one loop. Filter coefficients are ramped from the previous vowel
+ * to the selected vowel in 1 << FORMANT_FILTER_RAMP_STEPS_POW2 steps per block
+ * @note The state must be zero-initialized before first use
+ * @param vowel Vowel selection in Q0.16 format (0 = first vowel ... 1 = last vowel)
+ * @param state Struct holding formant filter state
+ * @param xBuffer Work buffer of size >= 2 * NOF_FORMANT_FILTER_STAGES allocated in x memory
+ * @param yBuffer Work buffer of size >= 5 * NOF_FORMANT_FILTER_STAGES allocated in y memory
+ * @param data Buffer of BLOCK_LEN samples to be filtered allocated in x memory
+ */
+void calcFormantFilterParallelBlockInplace(
+        const _Q16 vowel,
+        FormantFilterState * const state,
+        _Q15 * const xBuffer,
+        _Q15 * const yBuffer,
+        _Q15 * const data);
 
-#endif
\ No newline at end of file
+#endif
@@ -1,15 +1,53 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file formant_filter_types.h
+ * @brief Type definitions for formant filter
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
 #ifndef FORMANT_FILTER_TYPES_H
 #define	FORMANT_FILTER_TYPES_H
 
 #include "svf_2pole_types.h"
+#include "fp_lib_types.h"
 
+/// Number of cascaded SVF stages, i.e. number of formants
 #define NOF_FORMANT_FILTER_STAGES 4
 
+/// Number of vowel segments as power of two
+#define NOF_VOWELS_POW2 2
+
+/// Number of vowels
+#define NOF_VOWELS ((1 << NOF_VOWELS_POW2) + 1)
+
+/// Number of coefficient ramp steps per block as power of two (parallel mode)
+#define FORMANT_FILTER_RAMP_STEPS_POW2 2
+
+/// Formant filter state
 typedef struct
 {
+    /// SVF state of each filter stage
     SVF2PoleState states[NOF_FORMANT_FILTER_STAGES];
-} FormantFilterState;
 
+    /// Vowel selection of previous block (needed for coefficient ramping in parallel mode)
+    _Q16 vowel;
+} FormantFilterState;
 
 #endif
-
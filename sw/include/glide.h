@@ -32,13 +32,31 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 /**
  * @brief Update Glide
  * 
- * Update the Glide state from glide transition parameters and return the output value calculated from the updated state
- * @param params Struct holding ADSR envelope parameters
- * @param state Struct holding ADSR envelope state
+ * Update the Glide state from glide transition parameters and return the output value calculated from the updated state.
+ * None of the glide modes divides, the approximate cost per update (without call overhead) is
+ * - GLIDE_MODE_EXPONENTIAL: ~10 cycles (one 16x16 multiplication)
+ * - GLIDE_MODE_LINEAR_RATE: ~20 cycles (32-bit difference and clamp)
+ * - GLIDE_MODE_CONSTANT_TIME: ~15 cycles, plus ~40 cycles on a note change (two table reads, two 16x16 multiplications)
+ * @param params Struct holding glide parameters
+ * @param state Struct holding glide state
  * @return Glide output value in half-cent format
  */
 int16_t updateGlide(
         const GlideParams * const params,
         GlideState * const state);
 
+/**
+ * @brief Update Glide for one block of samples
+ * 
+ * Update the Glide state once per block like updateGlide() and write a linear ramp from the previous to the updated
+ * output value, so long glides do not step at block boundaries. The last sample equals the value updateGlide() would return
+ * @param params Struct holding glide parameters
+ * @param state Struct holding glide state
+ * @param data Buffer of BLOCK_LEN samples to be filled with glide output values in half-cent format
+ */
+void updateGlideBlock(
+        const GlideParams * const params,
+        GlideState * const state,
+        int16_t * data);
+
 #endif
@@ -29,22 +29,44 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include <stdint.h>
 #include <stdbool.h>
 
+/// Glide mode
+typedef enum
+{
+    GLIDE_MODE_EXPONENTIAL = 0, // One-pole glide, the glide speed is proportional to the remaining note difference
+    GLIDE_MODE_LINEAR_RATE,     // Linear glide with constant rate in half-cents per update
+    GLIDE_MODE_CONSTANT_TIME    // Linear glide reaching the final note after a constant number of updates
+} GlideMode;
 
 /// Glide state
 typedef struct
 {
     /// Current glide value
     Long value;
+
+    /// Final note of the current constant time glide in half-cent format
+    int16_t note;
+
+    /// Remaining number of updates of the current constant time glide
+    uint16_t remaining;
+
+    /// Increment per update of the current constant time glide
+    Long increment;
 } GlideState;
 
 /// Glide parameters
 typedef struct
 {
     /// Glide time
+    // GLIDE_MODE_EXPONENTIAL - Weight of the note difference per update in Q0.16 format
+    // GLIDE_MODE_LINEAR_RATE - Glide rate in 1/256 half-cents per update
+    // GLIDE_MODE_CONSTANT_TIME - Glide time, 0 ... 65535 map exponentially to 1 ... 4096 updates
     uint16_t rate;
     
     /// Final note in half-cent format
     int16_t note;
+
+    /// Glide mode
+    GlideMode mode;
 } GlideParams;
 
 #endif
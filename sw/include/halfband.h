@@ -0,0 +1,210 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file halfband.h
+ * @brief Implementation of polyphase halfband interpolator and decimator
+ *
+ * The halfband filter has 15 taps, every other side tap is zero. Passband ripple is < 0.03 dB (+0.027 / -0.019 dB)
+ * up to 0.15 * fs, stopband attenuation is > 50 dB above 0.35 * fs (fs = oversampled sample rate)
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#ifndef HALFBAND_H
+#define	HALFBAND_H
+
+#include "halfband_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Halfband filter coefficients (unique side coefficients from outer to inner tap, followed by center coefficient)
+ * Defined in halfband.c
+ */
+extern const _Q15 halfbandCoeffs[HALFBAND_COEFF_BUFFER_LEN];
+
+/**
+ * @brief Copy a buffer
+ * @param src Source buffer
+ * @param dst Destination buffer
+ * @param len Number of samples to be copied (len > 0)
+ */
+static inline void copyHalfbandBuffer(
+                                      const _Q15 * src,
+                                      _Q15 * dst,
+                                      const uint16_t len)
+{
+    __asm__ volatile(
+            "\
+        repeat  %[len]                     ;\n \
+        mov     [%[src]++], [%[dst]++]     ;\n \
+        ; 2 + N cycles total"
+            : [dst] "+r"(dst), [src] "+r"(src) /*out*/
+            : [len] "r"(len - 1) /*in*/
+            : /*clobbered*/
+            );
+}
+
+/**
+ * @brief Copy halfband filter coefficients to y memory
+ * @param yBuffer Work buffer of size >= HALFBAND_COEFF_BUFFER_LEN allocated in y memory
+ */
+static inline void copyHalfbandCoeffs(_Q15 * const yBuffer)
+{
+    copyHalfbandBuffer(
+            halfbandCoeffs,
+            yBuffer,
+            HALFBAND_COEFF_BUFFER_LEN);
+}
+
+/**
+ * @brief Interpolation of samples by factor 2 using polyphase halfband filter
+ *
+ * The non-zero side taps form one polyphase branch, the center tap forms the other one (pure delay).
+ * Symmetry of the side taps is exploited by reading the unique coefficients forth and back
+ * @param coeffs Halfband filter coefficients as copied by copyHalfbandCoeffs() allocated in y memory
+ * @param state Struct holding halfband interpolator state
+ * @param xBuffer Work buffer of size >= len + HALFBAND_INTERP_HISTORY_LEN allocated in x memory
+ * @param input Input buffer of len samples
+ * @param output Output buffer of 2 * len samples, may be the same as input buffer
+ * @param len Number of input samples
+ */
+static inline void calcHalfbandInterp2x(
+                                        const _Q15 * coeffs,
+                                        HalfbandInterpState * const state,
+                                        _Q15 * const xBuffer,
+                                        const _Q15 * const input,
+                                        _Q15 * output,
+                                        const uint16_t len)
+{
+    // Prepend history to input samples
+    copyHalfbandBuffer(
+            state->history,
+            xBuffer,
+            HALFBAND_INTERP_HISTORY_LEN);
+
+    copyHalfbandBuffer(
+            input,
+            xBuffer + HALFBAND_INTERP_HISTORY_LEN,
+            len);
+
+    // Loop all input samples
+    _Q15 * window = xBuffer;
+    __asm__ volatile(
+            "\
+    ;Start processing loop                                                      ;\n \
+        do %[len], HalfbandInterp2x_%=                                          ;\n \
+                                                                                ;\n \
+    ;Even output sample: y = 2 * sum(c[k] * (x[k] + x[7-k]))                    ;\n \
+        clr     A, [%[w]]+=2, w4, [%[a]]+=2, w5                                 ;AccA = 0, prefetch x[0] and c[0] \n \
+        mac     w4 * w5, A, [%[w]]+=2, w4, [%[a]]+=2, w5                        ;AccA += x[0] * c[0], prefetch x[1] and c[1] \n \
+        mac     w4 * w5, A, [%[w]]+=2, w4, [%[a]]+=2, w5                        ;AccA += x[1] * c[1], prefetch x[2] and c[2] \n \
+        mac     w4 * w5, A, [%[w]]+=2, w4, [%[a]], w5                           ;AccA += x[2] * c[2], prefetch x[3] and c[3] \n \
+        mac     w4 * w5, A, [%[w]]+=2, w4, [%[a]]-=2, w5                        ;AccA += x[3] * c[3], prefetch x[4] and c[3] \n \
+        mac     w4 * w5, A, [%[w]]+=2, w4, [%[a]]-=2, w5                        ;AccA += x[4] * c[3], prefetch x[5] and c[2] \n \
+        mac     w4 * w5, A, [%[w]]+=2, w4, [%[a]]-=2, w5                        ;AccA += x[5] * c[2], prefetch x[6] and c[1] \n \
+        mac     w4 * w5, A, [%[w]]-=6, w4, [%[a]], w5                           ;AccA += x[6] * c[1], prefetch x[7] and c[0] \n \
+        mac     w4 * w5, A, [%[w]]-=6, w4                                       ;AccA += x[7] * c[0], prefetch x[4], move window by one sample \n \
+        sac.r   A, #-1, [%[y]++]                                                ;Store AccA * 2 in y, increment y pointer \n \
+                                                                                ;\n \
+    ;Odd output sample: y = x[4] (center tap)                                   ;\n \
+    HalfbandInterp2x_%=:                                                        ;\n \
+        mov     w4, [%[y]++]                                                    ;Store x[4] in y, increment y pointer \n \
+                                                                                ;\n \
+        ; 2 + 11N cycles total"
+            : [y]"+r"(output), [w]"+x"(window), [a]"+y"(coeffs) /*out*/
+            : [len]"r"(len - 1) /*in*/
+            : "w4", "w5" /*clobbered*/
+            );
+
+    // Store history for next call
+    copyHalfbandBuffer(
+            xBuffer + len,
+            state->history,
+            HALFBAND_INTERP_HISTORY_LEN);
+}
+
+/**
+ * @brief Decimation of samples by factor 2 using polyphase halfband filter
+ *
+ * Only every second output sample of the halfband filter is calculated. The non-zero side taps are applied to the
+ * even input samples, the center tap to the odd input samples.
+ * Symmetry of the side taps is exploited by reading the unique coefficients forth and back
+ * @param coeffs Halfband filter coefficients as copied by copyHalfbandCoeffs() allocated in y memory
+ * @param state Struct holding halfband decimator state
+ * @param xBuffer Work buffer of size >= 2 * len + HALFBAND_DECIM_HISTORY_LEN allocated in x memory
+ * @param input Input buffer of 2 * len samples
+ * @param output Output buffer of len samples, may be the same as input buffer
+ * @param len Number of output samples
+ */
+static inline void calcHalfbandDecim2x(
+                                       const _Q15 * coeffs,
+                                       HalfbandDecimState * const state,
+                                       _Q15 * const xBuffer,
+                                       const _Q15 * const input,
+                                       _Q15 * output,
+                                       const uint16_t len)
+{
+    // Prepend history to input samples
+    copyHalfbandBuffer(
+            state->history,
+            xBuffer,
+            HALFBAND_DECIM_HISTORY_LEN);
+
+    copyHalfbandBuffer(
+            input,
+            xBuffer + HALFBAND_DECIM_HISTORY_LEN,
+            2 * len);
+
+    // Loop all output samples
+    _Q15 * window = xBuffer;
+    __asm__ volatile(
+            "\
+    ;Start processing loop                                                      ;\n \
+        do %[len], HalfbandDecim2x_%=                                           ;\n \
+                                                                                ;\n \
+    ;y = sum(c[k] * (x[2k] + x[14-2k])) + 0.5 * x[7]                            ;\n \
+        clr     A, [%[w]]+=4, w4, [%[a]]+=2, w5                                 ;AccA = 0, prefetch x[0] and c[0] \n \
+        mac     w4 * w5, A, [%[w]]+=4, w4, [%[a]]+=2, w5                        ;AccA += x[0] * c[0], prefetch x[2] and c[1] \n \
+        mac     w4 * w5, A, [%[w]]+=4, w4, [%[a]]+=2, w5                        ;AccA += x[2] * c[1], prefetch x[4] and c[2] \n \
+        mac     w4 * w5, A, [%[w]]+=2, w4, [%[a]]+=2, w5                        ;AccA += x[4] * c[2], prefetch x[6] and c[3] \n \
+        mac     w4 * w5, A, [%[w]]+=2, w4, [%[a]]-=2, w5                        ;AccA += x[6] * c[3], prefetch x[7] and center coefficient \n \
+        mac     w4 * w5, A, [%[w]]+=4, w4, [%[a]]-=2, w5                        ;AccA += x[7] * 0.5, prefetch x[8] and c[3] \n \
+        mac     w4 * w5, A, [%[w]]+=4, w4, [%[a]]-=2, w5                        ;AccA += x[8] * c[3], prefetch x[10] and c[2] \n \
+        mac     w4 * w5, A, [%[w]]+=4, w4, [%[a]]-=2, w5                        ;AccA += x[10] * c[2], prefetch x[12] and c[1] \n \
+        mac     w4 * w5, A, [%[w]], w4, [%[a]], w5                              ;AccA += x[12] * c[1], prefetch x[14] and c[0] \n \
+        mac     w4 * w5, A                                                      ;AccA += x[14] * c[0] \n \
+        sub     #24, %[w]                                                       ;Move window by two samples \n \
+                                                                                ;\n \
+    HalfbandDecim2x_%=:                                                         ;\n \
+        sac.r   A, #0, [%[y]++]                                                 ;Store AccA in y, increment y pointer \n \
+                                                                                ;\n \
+        ; 2 + 12N cycles total"
+            : [y]"+r"(output), [w]"+x"(window), [a]"+y"(coeffs) /*out*/
+            : [len]"r"(len - 1) /*in*/
+            : "w4", "w5" /*clobbered*/
+            );
+
+    // Store history for next call
+    copyHalfbandBuffer(
+            xBuffer + 2 * len,
+            state->history,
+            HALFBAND_DECIM_HISTORY_LEN);
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file halfband_types.h
+ * @brief Type definitions for polyphase halfband filters
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef HALFBAND_TYPES_H
+#define	HALFBAND_TYPES_H
+
+#include "fp_lib_types.h"
+
+/// Number of unique non-zero side coefficients of the halfband filter (filter length is 4 * HALFBAND_NOF_COEFFS - 1)
+#define HALFBAND_NOF_COEFFS 4
+
+/// Number of coefficients stored in y memory (unique side coefficients followed by center coefficient)
+#define HALFBAND_COEFF_BUFFER_LEN (HALFBAND_NOF_COEFFS + 1)
+
+/// History length of the halfband interpolator in input samples
+#define HALFBAND_INTERP_HISTORY_LEN (2 * HALFBAND_NOF_COEFFS - 1)
+
+/// History length of the halfband decimator in input samples
+#define HALFBAND_DECIM_HISTORY_LEN (4 * HALFBAND_NOF_COEFFS - 2)
+
+/// Halfband interpolator state
+typedef struct
+{
+    /// Past input samples
+    _Q15 history[HALFBAND_INTERP_HISTORY_LEN];
+} HalfbandInterpState;
+
+/// Halfband decimator state
+typedef struct
+{
+    /// Past input samples
+    _Q15 history[HALFBAND_DECIM_HISTORY_LEN];
+} HalfbandDecimState;
+
+#endif
@@ -145,6 +145,58 @@ inline static void calcLP1PoleBlock(
     state->stateScaling = stateScaling;
 }
 
+/**
+ * @brief Filter a block of samples with variable length by 1-pole IIR lowpass filter
+ * @note Use this function for blocks not equal to BLOCK_LEN, e.g. for signals at reduced sample rate
+ * @param alpha Alpha parameter in Q0.15 format
+ * @param state Struct holding 1-pole IIR filter struct
+ * @param data Block of data samples to be filtered in Q0.15 format
+ * @param len Number of samples to be filtered (len > 0)
+ */
+inline static void calcLP1PoleBlockLen(
+                                       const _Q15 alpha,
+                                       IIROnePoleState * const state,
+                                       _Q15 * data,
+                                       const uint16_t len)
+{
+    // Calculate 1-pole low pass filter in-place (0 <= a < 1)
+    // s = a * s + (1-a) * x(k);
+    // y(k) = s;
+ 
+    // Load filter state
+    _Q15 stateValue = state->stateValue;
+    int16_t stateScaling = state->stateScaling;
+
+    // For accumulator normalizing see section 4.19 of the 16-Bit MCU and DSC Programmer's Reference Manual
+    __asm__ volatile(
+            "\
+        do %[Len], CalcLP1PoleLen_%=                                            ;\n \
+                                                                                ;\n \
+        mpy     %[stateValue] * %[alpha], A                                     ;AccA = stateValue * alpha \n \
+        neg     %[stateScaling], %[stateScaling]                                ;stateScaling = -stateScaling \n \
+        sftac   A, %[stateScaling]                                              ;De-normalize AccA \n \
+        mov     [%[x]], w4                                                      ;Prefetch x(k) into w4 \n \
+        msc     w4 * %[alpha], A                                                ;AccA -= x(k) * alpha \n \
+        add     w4, #0, A                                                       ;AccA += x(k) \n \
+        sac.r   A, #0, [%[x]++]                                                 ;x[k++] = AccA \n \
+        mov     #ACCAH, w4                                                      ;Dump upper word of AccA into w4 \n \
+        fbcl    [w4], %[stateScaling]                                           ;Calculate stateScaling for full scale \n \
+        sftac   A, %[stateScaling]                                              ;Normalize AccA \n \
+                                                                                ;\n \
+    CalcLP1PoleLen_%=:                                                          ;\n \
+        sac.r   A, #0, %[stateValue]                                            ;stateValue = AccA \n \
+                                                                                ;\n \
+        ; 2 + 11N cycles total"
+            : [x]"+r"(data), [stateValue]"+z"(stateValue), [stateScaling]"+r"(stateScaling)/*out*/
+            : [Len]"r"(len - 1), [alpha]"z"(alpha) /*in*/
+            : "w4" /*clobbered*/
+            );
+
+    // Store filter state
+    state->stateValue = stateValue;
+    state->stateScaling = stateScaling;
+}
+
 /**
  * @brief Filter one sample by 1-pole IIR highpass filter
  * @param alpha Alpha parameter in Q0.15 format
@@ -244,4 +296,57 @@ inline static void calcHP1PoleBlock(
     state->stateScaling = stateScaling;
 }
 
+/**
+ * @brief Filter a block of samples with variable length by 1-pole IIR highpass filter
+ * @note Use this function for blocks not equal to BLOCK_LEN, e.g. for signals at reduced sample rate
+ * @param alpha Alpha parameter in Q0.15 format
+ * @param state Struct holding 1-pole IIR filter struct
+ * @param data Block of data samples to be filtered in Q0.15 format
+ * @param len Number of samples to be filtered (len > 0)
+ */
+inline static void calcHP1PoleBlockLen(
+                                       const _Q15 alpha,
+                                       IIROnePoleState * const state,
+                                       _Q15 * data,
+                                       const uint16_t len)
+{
+    // Calculate 1-pole high pass filter in-place (0 <= a < 1)
+    // y(k) = a * (x(k) - s))
+    // s = x(k) - y(k))
+ 
+    // Load filter state
+    _Q15 stateValue = state->stateValue;
+    int16_t stateScaling = state->stateScaling;
+
+    // For accumulator normalizing see section 4.19 of the 16-Bit MCU and DSC Programmer's Reference Manual
+    __asm__ volatile(
+            "\
+        do %[Len], CalcHP1PoleLen_%=                                            ;\n \
+                                                                                ;\n \
+        mpy.n   %[stateValue] * %[alpha], A                                     ;AccA = -stateValue * alpha \n \
+        neg     %[stateScaling], %[stateScaling]                                ;stateScaling = -stateScaling \n \
+        sftac   A, %[stateScaling]                                              ;De-normalize AccA \n \
+        mov     [%[x]], w4                                                      ;Prefetch x(k) into w4 \n \
+        mac     w4 * %[alpha], A                                                ;AccA += x(k) * alpha \n \
+        sac.r   A, #0, [%[x]++]                                                 ;x[k++] = AccA \n \
+        neg     A                                                               ;AccA = -AccA \n \
+        add     w4, #0, A                                                       ;AccA += x[k] \n \
+        mov     #ACCAH, w4                                                      ;Dump upper word of AccA into w4 \n \
+        fbcl    [w4], %[stateScaling]                                           ;Calculate stateScaling for full scale \n \
+        sftac   A, %[stateScaling]                                              ;Normalize AccA \n \
+                                                                                ;\n \
+    CalcHP1PoleLen_%=:                                                          ;\n \
+        sac.r   A, #0, %[stateValue]                                            ;stateValue = AccA \n \
+                                                                                ;\n \
+        ; 2 + 12N cycles total"
+            : [x]"+r"(data), [stateValue]"+z"(stateValue), [stateScaling]"+r"(stateScaling)/*out*/
+            : [Len]"r"(len - 1), [alpha]"z"(alpha) /*in*/
+            : "w4" /*clobbered*/
+            );
+
+    // Store filter state
+    state->stateValue = stateValue;
+    state->stateScaling = stateScaling;
+}
+
 #endif
\ No newline at end of file
@@ -26,7 +26,76 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #define	LFO_H
 
 #include "lfo_types.h"
+#include "transport_types.h"
 #include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Interpolation table for LFO rate to frequency conversion
+ * Defined in lfo.c
+ */
+extern const _Q15 lfoRateToFreqTable[257];
+
+/**
+ * @brief Calculate 4-point Hermite (Catmull-Rom) interpolation coefficients
+ * 
+ * The interpolation curve runs from y0 to y1, the outer points y(-1) and y2 define the slopes at the segment ends.
+ * The coefficients are scaled to 16 bit, |c1| <= 1 is given in Q2.13 format, |c2| <= 6 and |c3| <= 4 in Q3.12 format
+ * @param ym1 Value before the segment in Q0.15 format
+ * @param y0 Value at the segment start in Q0.15 format
+ * @param y1 Value at the segment end in Q0.15 format
+ * @param y2 Value after the segment in Q0.15 format
+ * @param coeffs Interpolation coefficients c1 (Q2.13), c2 (Q3.12) and c3 (Q3.12)
+ */
+static inline void calcLFOHermiteCoeffs(
+                                        const _Q15 ym1,
+                                        const _Q15 y0,
+                                        const _Q15 y1,
+                                        const _Q15 y2,
+                                        int16_t * const coeffs)
+{
+    // c1 = 0.5 * (y1 - y(-1))
+    // c2 = y(-1) - 2.5 * y0 + 2 * y1 - 0.5 * y2
+    // c3 = 0.5 * (y2 - y(-1)) + 1.5 * (y0 - y1)
+    coeffs[0] = ((int32_t) y1 - ym1) >> 3;
+    coeffs[1] = (2 * (int32_t) ym1 - 5 * (int32_t) y0 + 4 * (int32_t) y1 - y2) >> 4;
+    coeffs[2] = ((int32_t) y2 - ym1 + 3 * ((int32_t) y0 - y1)) >> 4;
+}
+
+/**
+ * @brief Calculate one 4-point Hermite (Catmull-Rom) interpolated value
+ * 
+ * The curve may overshoot the interpolated values by up to 25 %, the result is saturated to Q0.15 range.
+ * The position within the segment is evaluated with 15 bit resolution
+ * @param coeffs Interpolation coefficients calculated by calcLFOHermiteCoeffs()
+ * @param y0 Value at the segment start in Q0.15 format
+ * @param phase Position within the segment in Q0.16 format
+ * @return Interpolated value in Q0.15 format
+ */
+static inline _Q15 calcLFOHermiteSample(
+                                        const int16_t * const coeffs,
+                                        const _Q15 y0,
+                                        const _Q16 phase)
+{
+    // Horner scheme with t in Q0.15 format and 16 bit multiplications.
+    // |c3 * t + c2| <= 6 stays within Q3.12, |(c3 * t + c2) * t + c1| <= 7/3 stays within Q2.13
+    const int16_t t = phase >> 1;
+    int16_t y = (__builtin_mulss(coeffs[2], t) >> 15) + coeffs[1];
+    y = (__builtin_mulss(y, t) >> 14) + coeffs[0];
+    const int32_t value = (__builtin_mulss(y, t) >> 13) + y0;
+
+    // Saturate overshoot
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    else if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+
+    return value;
+}
 
 /**
  * @brief Update LFO
@@ -40,6 +109,21 @@ _Q15 updateLFO(
         const LFOParams * params,
         LFOState * state);
 
+/**
+ * @brief Update LFO at audio rate
+ * 
+ * Update the LFO state from LFO parameters and calculate one block of output values. The phase advances by
+ * the same amount per block as with updateLFO(), spread evenly over the block, so the last output value
+ * matches the value updateLFO() would return
+ * @param params Struct holding LFO parameters
+ * @param state Struct holding LFO state
+ * @param data Buffer of BLOCK_LEN samples to be filled with LFO output values in Q0.15 format
+ */
+void updateLFOBlock(
+        const LFOParams * params,
+        LFOState * state,
+        _Q15 * data);
+
 /**
  * @brief Update LFO in hard-sync mode
  * 
@@ -59,6 +143,23 @@ _Q15 updateLFOSync(
         _Q16 phaseMaster,
         _Q16 syncPhase);
 
+/**
+ * @brief Update LFO synced to transport clock
+ * 
+ * The LFO phase is derived from the transport song position by multiplication with the sync ratio, i.e. without
+ * per-update division. The sync flag is set when the synced phase wraps around
+ * @param waveform Selected LFO waveform type
+ * @param state Struct holding LFO state
+ * @param transport Struct holding transport clock state
+ * @param ratio Number of LFO cycles per beat in Q16.16 format, see TRANSPORT_RATIO()
+ * @return LFO output value in Q0.15 format
+ */
+_Q15 updateLFOTransport(
+        LFOWaveform waveform,
+        LFOState * state,
+        const TransportState * transport,
+        uint32_t ratio);
+
 /**
  * @brief Update LFO in hard-reset mode
  * 
@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file lfo_bank.h
+ * @brief Function prototypes for LFO bank calculation
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef LFO_BANK_H
+#define	LFO_BANK_H
+
+#include "lfo_bank_types.h"
+#include "lfo_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Initialize LFO bank
+ *
+ * All LFOs are reset to phase 0, rate 0 and the selected waveform
+ * @param bank Struct holding LFO bank state
+ * @param waveform Initial LFO waveform type for all LFOs
+ */
+void initLFOBank(
+        LFOBank * bank,
+        LFOWaveform waveform);
+
+/**
+ * @brief Set parameters of one LFO of an LFO bank
+ *
+ * The rate to frequency conversion is only done if the rate has changed. A waveform change regroups the bank
+ * on the next update
+ * @param bank Struct holding LFO bank state
+ * @param index LFO number (index < NOF_LFO_BANK_LFOS)
+ * @param params Struct holding LFO parameters
+ */
+void setLFOBankParams(
+        LFOBank * bank,
+        uint16_t index,
+        const LFOParams * params);
+
+/**
+ * @brief Update all LFOs of an LFO bank
+ *
+ * Each waveform group is processed by a dedicated loop without per-LFO waveform dispatch.
+ * The output values are stored in bank->output[], behaving like updateLFO() for each LFO
+ * @param bank Struct holding LFO bank state
+ */
+void updateLFOBank(LFOBank * bank);
+
+#endif
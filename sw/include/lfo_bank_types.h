@@ -0,0 +1,87 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file lfo_bank_types.h
+ * @brief Definition of LFO bank types
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef LFO_BANK_TYPES_H
+#define	LFO_BANK_TYPES_H
+
+#include "LFO_enums.h"
+#include "fp_lib_types.h"
+#include "rand_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/// Number of LFOs in an LFO bank (e.g. 16 voices with 2 LFOs each)
+#define NOF_LFO_BANK_LFOS 32
+
+/// Number of waveform groups in an LFO bank
+#define NOF_LFO_BANK_GROUPS 6
+
+/**
+ * LFO bank state
+ *
+ * The LFO states are stored as structure of arrays, indexed by LFO number
+ */
+typedef struct
+{
+    /// Current LFO phase
+    _Q16 phase[NOF_LFO_BANK_LFOS];
+
+    /// Cached LFO frequency (phase increment per update)
+    _Q16 freq[NOF_LFO_BANK_LFOS];
+
+    /// LFO rate the cached frequency was calculated for
+    _Q16 rate[NOF_LFO_BANK_LFOS];
+
+    /// LFO waveform type
+    LFOWaveform waveform[NOF_LFO_BANK_LFOS];
+
+    /// Current LFO value (needed for S&H and random)
+    _Q15 currentValue[NOF_LFO_BANK_LFOS];
+
+    /// Last LFO value (needed for random)
+    _Q15 lastValue[NOF_LFO_BANK_LFOS];
+
+    /// LFO value before the last value (needed for random)
+    _Q15 previousValue[NOF_LFO_BANK_LFOS];
+
+    /// Next LFO value after the current value (needed for random)
+    _Q15 nextValue[NOF_LFO_BANK_LFOS];
+
+    /// LFO output value of the last update
+    _Q15 output[NOF_LFO_BANK_LFOS];
+
+    /// LFO numbers sorted by waveform group
+    uint16_t groupIndex[NOF_LFO_BANK_LFOS];
+
+    /// Number of LFOs in each waveform group
+    uint16_t groupLen[NOF_LFO_BANK_GROUPS];
+
+    /// Flag indicating that the waveform groups are up to date
+    bool groupsValid;
+
+    /// Pseudo-random number generator state shared by all S&H and random LFOs of the bank
+    RandState rand;
+} LFOBank;
+
+#endif
@@ -27,6 +27,8 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "LFO_enums.h"
 #include "fp_lib_types.h"
+#include "rand_types.h"
+#include <stdint.h>
 #include <stdbool.h>
 
 /// LFO state
@@ -43,6 +45,18 @@ typedef struct
 
     /// Last LFO output value (needed for random)
     _Q15 lastValue;
+
+    /// LFO value before the last value (needed for random)
+    _Q15 previousValue;
+
+    /// Next LFO value after the current value (needed for random)
+    _Q15 nextValue;
+
+    /// Pseudo-random number generator state (needed for S&H and random)
+    RandState rand;
+
+    /// Number of completed cycles (needed for transport sync)
+    uint16_t cycle;
 } LFOState;
 
 /// LFO parameters
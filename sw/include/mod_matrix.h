@@ -0,0 +1,140 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file mod_matrix.h
+ * @brief Implementation of modulation matrix
+ * 
+ * The routing table is compiled into a flat instruction list once per routing change by compileModMatrix(). The
+ * destination values are set to their unmodulated values by the caller, then the modulation of all routes is
+ * accumulated with saturation.
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef MOD_MATRIX_H
+#define	MOD_MATRIX_H
+
+#include "mod_matrix_types.h"
+#include "fp_lib_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+
+/**
+ * @brief Compile modulation matrix
+ * 
+ * Call this function whenever the routing table has changed
+ * @param matrix Struct holding modulation matrix
+ * @param program Struct holding compiled modulation matrix
+ */
+void compileModMatrix(
+        const ModMatrix * matrix,
+        ModMatrixProgram * program);
+
+/**
+ * @brief Evaluate the block rate routes of a compiled modulation matrix
+ * 
+ * destination[d] += amount * source[s] for all routes with saturation, without per-route branching
+ * @param program Struct holding compiled modulation matrix
+ * @param sources Modulation source values of one voice in Q0.15 format (NOF_MOD_SOURCES values)
+ * @param destinations Modulation destination values of one voice in Q0.15 format (NOF_MOD_DESTINATIONS values)
+ */
+inline static void evalModMatrix(
+                                 const ModMatrixProgram * const program,
+                                 const _Q15 * const sources,
+                                 _Q15 * const destinations)
+{
+    const uint16_t len = program->nofBlockRoutes;
+    const int16_t * routes = program->blockRoutes;
+
+    if (len)
+    {
+        __asm__ volatile(
+                "\
+    ;Start processing loop                                                      ;\n \
+    ;Offsets are loaded ahead of their use as [Ws+Wb] to avoid address stalls   ;\n \
+        do      %[len], EvalModMatrix_%=                                        ;\n \
+        mov     [%[r]++], w5                                                    ;w5 = source byte offset \n \
+        mov     [%[r]++], w6                                                    ;w6 = amount \n \
+        mov     [%[r]++], w7                                                    ;w7 = destination byte offset \n \
+        mov     [%[src]+w5], w4                                                 ;w4 = source value \n \
+        lac     [%[dst]+w7], A                                                  ;AccA = destination value \n \
+        mac     w4 * w6, A                                                      ;AccA += source value * amount \n \
+    EvalModMatrix_%=:                                                           ;\n \
+        sac.r   A, #0, [%[dst]+w7]                                              ;Store AccA in destination (saturated) \n \
+                                                                                ;\n \
+        ; 2 + 7N cycles total"
+                : [r]"+r"(routes) /*out*/
+                : [len]"r"(len - 1), [src]"r"(sources), [dst]"r"(destinations) /*in*/
+                : "w4", "w5", "w6", "w7", "memory" /*clobbered*/
+                );
+    }
+}
+
+/**
+ * @brief Add one audio rate modulation route to a destination buffer
+ * @param amount Modulation amount in Q0.15 format
+ * @param source Source buffer of BLOCK_LEN samples in Q0.15 format
+ * @param destination Destination buffer of BLOCK_LEN samples in Q0.15 format
+ */
+inline static void addModRouteBlock(
+                                    const _Q15 amount,
+                                    const _Q15 * source,
+                                    _Q15 * destination)
+{
+    __asm__ volatile(
+            "\
+    ;Start processing loop                                                      ;\n \
+        do #%[Len]-1, AddModRouteBlock_%=                                       ;\n \
+        mov     [%[src]++], w4                                                  ;w4 = source sample \n \
+        lac     [%[dst]], A                                                     ;AccA = destination sample \n \
+        mac     w4 * %[amount], A                                               ;AccA += source sample * amount \n \
+    AddModRouteBlock_%=:                                                        ;\n \
+        sac.r   A, #0, [%[dst]++]                                               ;Store AccA in destination (saturated), increment pointer \n \
+                                                                                ;\n \
+        ; 2 + 4N cycles total"
+            : [src]"+r"(source), [dst]"+r"(destination) /*out*/
+            : [Len]"i"(BLOCK_LEN), [amount]"z"(amount) /*in*/
+            : "w4" /*clobbered*/
+            );
+}
+
+/**
+ * @brief Evaluate the audio rate routes of a compiled modulation matrix
+ * 
+ * destination[d][k] += amount * source[s][k] for all audio rate routes and all samples with saturation
+ * @param program Struct holding compiled modulation matrix
+ * @param sources Modulation source buffers of one voice (BLOCK_LEN samples each in Q0.15 format)
+ * @param destinations Modulation destination buffers of one voice (BLOCK_LEN samples each in Q0.15 format)
+ */
+inline static void evalModMatrixBlock(
+                                      const ModMatrixProgram * const program,
+                                      const _Q15 * const * const sources,
+                                      _Q15 * const * const destinations)
+{
+    const ModRoute * route = program->audioRoutes;
+
+    for (uint16_t i = 0; i < program->nofAudioRoutes; i++, route++)
+    {
+        addModRouteBlock(
+                         route->amount,
+                         sources[route->source],
+                         destinations[route->destination]);
+    }
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file mod_matrix_types.h
+ * @brief Definition of modulation matrix types
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef MOD_MATRIX_TYPES_H
+#define	MOD_MATRIX_TYPES_H
+
+#include "fp_lib_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/// Maximum number of modulation routes
+#define NOF_MOD_ROUTES 16
+
+/// Number of modulation sources per voice (e.g. LFOs, envelopes, velocity)
+#define NOF_MOD_SOURCES 16
+
+/// Number of modulation destinations per voice (e.g. oscillator shape, SVF note and resonance, pan)
+#define NOF_MOD_DESTINATIONS 16
+
+/// Modulation route
+typedef struct
+{
+    /// Modulation source index (< NOF_MOD_SOURCES)
+    uint8_t source;
+
+    /// Modulation destination index (< NOF_MOD_DESTINATIONS)
+    uint8_t destination;
+
+    /// Modulation amount
+    _Q15 amount;
+
+    /// Flag indicating the route is evaluated at audio rate
+    bool audioRate;
+} ModRoute;
+
+/// Modulation matrix, i.e. routing table
+typedef struct
+{
+    /// Modulation routes
+    ModRoute route[NOF_MOD_ROUTES];
+
+    /// Number of modulation routes
+    uint16_t nofRoutes;
+} ModMatrix;
+
+/**
+ * Compiled modulation matrix
+ *
+ * Unused routes (zero amount, invalid index) are removed and block rate routes are stored as flat instruction list
+ * of (source byte offset, amount, destination byte offset)
+ */
+typedef struct
+{
+    /// Instruction list of block rate routes
+    int16_t blockRoutes[3 * NOF_MOD_ROUTES];
+
+    /// Number of block rate routes
+    uint16_t nofBlockRoutes;
+
+    /// Audio rate routes
+    ModRoute audioRoutes[NOF_MOD_ROUTES];
+
+    /// Number of audio rate routes
+    uint16_t nofAudioRoutes;
+} ModMatrixProgram;
+
+#endif
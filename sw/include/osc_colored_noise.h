@@ -50,6 +50,7 @@ inline static void calcOscColoredNoiseParams(
  * @brief Calculate one sample of colored noise oscillator waveform
  * 
  * Update the oscillator state and calculate one waveform sample from the updated state 
+ * @note state->rand must be initialized by initRandState() or checked by checkRandState() once per block
  * @param params Struct holding colored noise oscillator parameters
  * @param state Struct holding colored noise oscillator state
  * @return Colored noise oscillator waveform sample in Q0.15 format
@@ -59,7 +60,7 @@ inline static _Q15 calcOscColoredNoiseSample(
                                              OscColoredNoiseState * const state)
 {
     // Get white noise sample
-    const _Q15 output = rand();
+    const _Q15 output = randSample(&state->rand);
 
     // Filter white noise according to color
     return calcVario1PoleSample(
@@ -68,4 +69,167 @@ inline static _Q15 calcOscColoredNoiseSample(
                                 output);
 }
 
+/**
+ * @brief Calculate one block of lowpass colored noise
+ *
+ * Pseudo-random number generation and 1-pole lowpass filtering are fused into one processing loop
+ * @param alpha Alpha parameter of the lowpass filter in Q0.15 format
+ * @param filterState Struct holding 1-pole IIR filter state
+ * @param randState Struct holding pseudo-random number generator state
+ * @param data Buffer of BLOCK_LEN samples to be filled with colored noise
+ */
+inline static void calcOscColoredNoiseLPBlock(
+                                              const _Q15 alpha,
+                                              IIROnePoleState * const filterState,
+                                              RandState * const randState,
+                                              _Q15 * data)
+{
+    checkRandState(randState);
+
+    // Cache states for use with inline assembly
+    uint16_t state1Low = randState->state1.low;
+    uint16_t state1High = randState->state1.high;
+    uint16_t state2Low = randState->state2.low;
+    uint16_t state2High = randState->state2.high;
+    _Q15 stateValue = filterState->stateValue;
+    int16_t stateScaling = filterState->stateScaling;
+
+    // For accumulator normalizing see section 4.19 of the 16-Bit MCU and DSC Programmer's Reference Manual
+    __asm__ volatile(
+            "\
+        do #%[Len]-1, CalcColoredNoiseLP_%=                                     ;\n \
+                                                                                ;\n \
+    ;x(k) = rand()                                                              ;\n \
+        xor     %[s2L], %[s1L], %[s1L]                                          ;state1 ^= state2 (low word) \n \
+        xor     %[s2H], %[s1H], %[s1H]                                          ;state1 ^= state2 (high word) \n \
+        add     %[s1L], %[s2L], %[s2L]                                          ;state2 += state1 (low word) \n \
+        addc    %[s1H], %[s2H], %[s2H]                                          ;state2 += state1 (high word), x(k) = high word of state2 \n \
+                                                                                ;\n \
+    ;s = a * s + (1-a) * x(k)                                                   ;\n \
+        mpy     %[stateValue] * %[alpha], A                                     ;AccA = stateValue * alpha \n \
+        neg     %[stateScaling], %[stateScaling]                                ;stateScaling = -stateScaling \n \
+        sftac   A, %[stateScaling]                                              ;De-normalize AccA \n \
+        msc     %[s2H] * %[alpha], A                                            ;AccA -= x(k) * alpha \n \
+        add     %[s2H], #0, A                                                   ;AccA += x(k) \n \
+        sac.r   A, #0, [%[x]++]                                                 ;x[k++] = AccA \n \
+        mov     #ACCAH, w4                                                      ;Dump upper word of AccA into w4 \n \
+        fbcl    [w4], %[stateScaling]                                           ;Calculate stateScaling for full scale \n \
+        sftac   A, %[stateScaling]                                              ;Normalize AccA \n \
+                                                                                ;\n \
+    CalcColoredNoiseLP_%=:                                                      ;\n \
+        sac.r   A, #0, %[stateValue]                                            ;stateValue = AccA \n \
+                                                                                ;\n \
+        ; 2 + 14N cycles total"
+            : [x]"+r"(data), [s1L]"+r"(state1Low), [s1H]"+r"(state1High), [s2L]"+r"(state2Low), [s2H]"+z"(state2High), [stateValue]"+z"(stateValue), [stateScaling]"+r"(stateScaling) /*out*/
+            : [Len]"i"(BLOCK_LEN), [alpha]"z"(alpha) /*in*/
+            : "w4" /*clobbered*/
+            );
+
+    // Write back states
+    randState->state1.low = state1Low;
+    randState->state1.high = state1High;
+    randState->state2.low = state2Low;
+    randState->state2.high = state2High;
+    filterState->stateValue = stateValue;
+    filterState->stateScaling = stateScaling;
+}
+
+/**
+ * @brief Calculate one block of highpass colored noise
+ *
+ * Pseudo-random number generation and 1-pole highpass filtering are fused into one processing loop
+ * @param alpha Alpha parameter of the highpass filter in Q0.15 format
+ * @param filterState Struct holding 1-pole IIR filter state
+ * @param randState Struct holding pseudo-random number generator state
+ * @param data Buffer of BLOCK_LEN samples to be filled with colored noise
+ */
+inline static void calcOscColoredNoiseHPBlock(
+                                              const _Q15 alpha,
+                                              IIROnePoleState * const filterState,
+                                              RandState * const randState,
+                                              _Q15 * data)
+{
+    checkRandState(randState);
+
+    // Cache states for use with inline assembly
+    uint16_t state1Low = randState->state1.low;
+    uint16_t state1High = randState->state1.high;
+    uint16_t state2Low = randState->state2.low;
+    uint16_t state2High = randState->state2.high;
+    _Q15 stateValue = filterState->stateValue;
+    int16_t stateScaling = filterState->stateScaling;
+
+    // For accumulator normalizing see section 4.19 of the 16-Bit MCU and DSC Programmer's Reference Manual
+    __asm__ volatile(
+            "\
+        do #%[Len]-1, CalcColoredNoiseHP_%=                                     ;\n \
+                                                                                ;\n \
+    ;x(k) = rand()                                                              ;\n \
+        xor     %[s2L], %[s1L], %[s1L]                                          ;state1 ^= state2 (low word) \n \
+        xor     %[s2H], %[s1H], %[s1H]                                          ;state1 ^= state2 (high word) \n \
+        add     %[s1L], %[s2L], %[s2L]                                          ;state2 += state1 (low word) \n \
+        addc    %[s1H], %[s2H], %[s2H]                                          ;state2 += state1 (high word), x(k) = high word of state2 \n \
+                                                                                ;\n \
+    ;y(k) = a * (x(k) - s), s = x(k) - y(k)                                     ;\n \
+        mpy.n   %[stateValue] * %[alpha], A                                     ;AccA = -stateValue * alpha \n \
+        neg     %[stateScaling], %[stateScaling]                                ;stateScaling = -stateScaling \n \
+        sftac   A, %[stateScaling]                                              ;De-normalize AccA \n \
+        mac     %[s2H] * %[alpha], A                                            ;AccA += x(k) * alpha \n \
+        sac.r   A, #0, [%[x]++]                                                 ;x[k++] = AccA \n \
+        neg     A                                                               ;AccA = -AccA \n \
+        add     %[s2H], #0, A                                                   ;AccA += x(k) \n \
+        mov     #ACCAH, w4                                                      ;Dump upper word of AccA into w4 \n \
+        fbcl    [w4], %[stateScaling]                                           ;Calculate stateScaling for full scale \n \
+        sftac   A, %[stateScaling]                                              ;Normalize AccA \n \
+                                                                                ;\n \
+    CalcColoredNoiseHP_%=:                                                      ;\n \
+        sac.r   A, #0, %[stateValue]                                            ;stateValue = AccA \n \
+                                                                                ;\n \
+        ; 2 + 15N cycles total"
+            : [x]"+r"(data), [s1L]"+r"(state1Low), [s1H]"+r"(state1High), [s2L]"+r"(state2Low), [s2H]"+z"(state2High), [stateValue]"+z"(stateValue), [stateScaling]"+r"(stateScaling) /*out*/
+            : [Len]"i"(BLOCK_LEN), [alpha]"z"(alpha) /*in*/
+            : "w4" /*clobbered*/
+            );
+
+    // Write back states
+    randState->state1.low = state1Low;
+    randState->state1.high = state1High;
+    randState->state2.low = state2Low;
+    randState->state2.high = state2High;
+    filterState->stateValue = stateValue;
+    filterState->stateScaling = stateScaling;
+}
+
+/**
+ * @brief Calculate one block of colored noise oscillator waveform
+ *
+ * The filter type is resolved once per block, noise generation and filtering run in one processing loop
+ * @note The processing cost is 14 (lowpass) or 15 (highpass) cycles per sample
+ * @param params Struct holding colored noise oscillator parameters
+ * @param state Struct holding colored noise oscillator state
+ * @param data Buffer of BLOCK_LEN samples to be filled with the oscillator waveform in Q0.15 format
+ */
+inline static void calcOscColoredNoiseBlock(
+                                            const OscColoredNoiseParams * const params,
+                                            OscColoredNoiseState * const state,
+                                            _Q15 * const data)
+{
+    if (params->filterParams.filterType)
+    {
+        calcOscColoredNoiseHPBlock(
+                                   params->filterParams.alpha,
+                                   &state->filterState,
+                                   &state->rand,
+                                   data);
+    }
+    else
+    {
+        calcOscColoredNoiseLPBlock(
+                                   params->filterParams.alpha,
+                                   &state->filterState,
+                                   &state->rand,
+                                   data);
+    }
+}
+
 #endif
\ No newline at end of file
@@ -28,6 +28,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include "fp_lib_types.h"
 #include "vario_1pole_types.h"
 #include "IIR_1Pole_types.h"
+#include "rand_types.h"
 
 /// Colored noise oscillator parameters
 typedef struct
@@ -44,6 +45,9 @@ typedef struct
     
     /// Filter state
     IIROnePoleState filterState;
+
+    /// Pseudo-random number generator state
+    RandState rand;
 } OscColoredNoiseState;
 
 #endif
\ No newline at end of file
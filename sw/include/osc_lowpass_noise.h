@@ -28,12 +28,13 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include "rand.h"
 #include "svf_2pole.h"
 #include "osc_lowpass_noise_types.h"
+#include "param_cache.h"
 #include "fp_lib_types.h"
 #include <stdint.h>
 
 /**
  * @brief Calculate parameters for lowpass noise oscillator
- * @param pitch Pitch on MIDI scale given in half-cents
+ * @param note Pitch on MIDI scale given in half-cents
  * @param shape1 Shape parameter in Q0.16 format representing the lowpass filter frequency
  * @param shape2 Shape parameter in Q0.16 format representing the lowpass filter resonance
  * @param params Struct holding lowpass noise oscillator parameters
@@ -64,10 +65,39 @@ inline static void calcOscLowPassNoiseParams(
                params->filterCoeffs);
 }
 
+/**
+ * @brief Calculate parameters for lowpass noise oscillator with change detection
+ * 
+ * Parameters are only recalculated if any input has changed since the last call
+ * @param note Pitch on MIDI scale given in half-cents
+ * @param shape1 Shape parameter in Q0.16 format representing the lowpass filter frequency
+ * @param shape2 Shape parameter in Q0.16 format representing the lowpass filter resonance
+ * @param cache Struct holding the parameter cache
+ * @param params Struct holding lowpass noise oscillator parameters
+ */
+inline static void calcOscLowPassNoiseParamsCached(
+                                                   const int16_t note,
+                                                   const _Q16 shape1,
+                                                   const _Q16 shape2,
+                                                   ParamCache * const cache,
+                                                   OscLowPassNoiseParams * const params)
+{
+    const uint16_t inputs[] = {note, shape1, shape2};
+    if (updateParamCache(cache, inputs, 3))
+    {
+        calcOscLowPassNoiseParams(
+                                  note,
+                                  shape1,
+                                  shape2,
+                                  params);
+    }
+}
+
 /**
  * @brief Calculate one sample of lowpass noise oscillator waveform
  * 
  * Update the oscillator state and calculate one waveform sample from the updated state
+ * @note state->rand must be initialized by initRandState() or checked by checkRandState() once per block
  * @param params Struct holding lowpass noise oscillator parameters
  * @param state Struct holding lowpass noise oscillator state
  * @return Lowpass noise oscillator waveform sample in Q0.15 format
@@ -77,7 +107,7 @@ inline static _Q15 calcOscLowPassNoiseSample(
                                              OscLowPassNoiseState * const state)
 {
     // Get white noise sample
-    _Q15 output = rand();
+    _Q15 output = randSample(&state->rand);
 
 
     // Cache pointers for use in inline assembly
@@ -118,5 +148,78 @@ inline static _Q15 calcOscLowPassNoiseSample(
     return output;
 }
 
+/**
+ * @brief Calculate one block of lowpass noise oscillator waveform
+ *
+ * Pseudo-random number generation and SVF lowpass filtering are fused into one processing loop,
+ * the filter coefficients are prefetched once per block
+ * @param params Struct holding lowpass noise oscillator parameters
+ * @param state Struct holding lowpass noise oscillator state
+ * @param data Buffer of BLOCK_LEN samples to be filled with the oscillator waveform in Q0.15 format
+ */
+inline static void calcOscLowPassNoiseBlock(
+                                            const OscLowPassNoiseParams * const params,
+                                            OscLowPassNoiseState * const state,
+                                            _Q15 * data)
+{
+    checkRandState(&state->rand);
+
+    // Cache states and pointers for use with inline assembly
+    uint16_t state1Low = state->rand.state1.low;
+    uint16_t state1High = state->rand.state1.high;
+    uint16_t state2Low = state->rand.state2.low;
+    uint16_t state2High = state->rand.state2.high;
+    const _Q15 * filterCoeffs = params->filterCoeffs;
+    _Q15 * filterState = state->filter.state;
+
+    __asm__ volatile(
+            "\
+        movsac  A, [%[s]]+=2, w4, [%[a]]+=2, w5                                 ;Prefetch s[0] and a[0] \n \
+                                                                                ;\n \
+    ;Start processing loop                                                      ;\n \
+        do #%[Len]-1, CalcLowPassNoise_%=                                       ;\n \
+                                                                                ;\n \
+    ;x = rand()                                                                 ;\n \
+        xor     %[s2L], %[s1L], %[s1L]                                          ;state1 ^= state2 (low word) \n \
+        xor     %[s2H], %[s1H], %[s1H]                                          ;state1 ^= state2 (high word) \n \
+        add     %[s1L], %[s2L], %[s2L]                                          ;state2 += state1 (low word) \n \
+        addc    %[s1H], %[s2H], %[s2H]                                          ;state2 += state1 (high word), x = high word of state2 \n \
+                                                                                ;\n \
+    ;v1 = a[0] * s[0] - a[1] * s[1] + a[1] * x                                  ;\n \
+        mpy     w4 * w5, A, [%[s]]-=2, w4, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w4 * w5, A                                                      ;AccA -= s[1] * a[1], keep a[1] \n \
+        mac     %[s2H] * w5, A, [%[a]]-=4, w5                                   ;AccA += x * a[1], prefetch a[2] \n \
+        sac.r   A, #0, w4                                                       ;Store AccA in w4 \n \
+                                                                                ;\n \
+    ;s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                             ;\n \
+        lac     [%[s]], #1, B                                                   ;AccB = 0.5 * s[0] \n \
+        sub     A                                                               ;AccA = v1 - 0.5 * s[0] \n \
+        sac.r   A, #-1, [%[s]]                                                  ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;v2 = s[1] + g * v1                                                         ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * a[2], prefetch s[0] and a[0] for next do-loop iteration \n \
+        add     [%[s]], #3, A                                                   ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+        sac.r   A, #-3, [%[x]++]                                                ;Store AccA in x (Q3.28 --> Q0.15), increment x pointer \n \
+                                                                                ;\n \
+    ;s[1] = 2 * v2 - s[1] = 2 * ( v2 - 0.5 * s[1] )                             ;\n \
+        lac     [%[s]], #4, B                                                   ;AccB = 0.5 * s[1] (Q0.15 --> Q3.12) \n \
+        sub     A                                                               ;AccA = v2 - 0.5 * s[1] \n \
+                                                                                ;\n \
+    CalcLowPassNoise_%=:                                                        ;\n \
+        sac.r   A, #-4, [%[s]]                                                  ;Store AccA * 2 in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+        ; 3 + 17N cycles total"
+            : [x]"+r"(data), [s]"+x"(filterState), [a]"+y"(filterCoeffs), [s1L]"+r"(state1Low), [s1H]"+r"(state1High), [s2L]"+r"(state2Low), [s2H]"+z"(state2High) /*out*/
+            : [Len]"i"(BLOCK_LEN) /*in*/
+            : "w4", "w5" /*clobbered*/
+            );
+
+    // Write back state
+    state->rand.state1.low = state1Low;
+    state->rand.state1.high = state1High;
+    state->rand.state2.low = state2Low;
+    state->rand.state2.high = state2High;
+}
+
 
 #endif
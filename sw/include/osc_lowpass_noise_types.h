@@ -27,6 +27,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "fp_lib_types.h"
 #include "svf_2pole_types.h"
+#include "rand_types.h"
 
 /// Lowpass noise oscillator parameters
 typedef struct
@@ -43,6 +44,9 @@ typedef struct
     
     /// Filter state
     SVF2PoleState filter;
+
+    /// Pseudo-random number generator state
+    RandState rand;
 } OscLowPassNoiseState;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file osc_pink_noise.h
+ * @brief Implementation of pink noise oscillator
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef OSC_PINK_NOISE_H
+#define	OSC_PINK_NOISE_H
+
+#include "osc_pink_noise_types.h"
+#include "rand.h"
+#include "block_len_def.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Calculate one block of pink noise oscillator waveform
+ *
+ * Pink noise is generated by the Voss-McCartney algorithm: every sample exactly one row is replaced by a new
+ * random value, row k being updated every 2^(k+1) samples (selected by the trailing zeros of a sample counter).
+ * The output is the sum of all rows plus one white noise value per sample. Each of the 16 terms is scaled
+ * by 1/16, so the output cannot overflow.
+ *
+ * Spectral error (derived from the analytic spectrum of the row sample-and-hold, 1/6 octave bands @ 48 kHz):
+ * The spectrum stays within +/-0.8 dB of an ideal -3 dB/octave slope between 20 Hz and 20 kHz, with
+ * a slight droop of up to ~1 dB towards the upper end. The two lowest rows are both updated every 2^14
+ * samples, so the spectrum flattens out below ~3 Hz.
+ * @note A zero-initialized state is valid
+ * @param state Struct holding pink noise oscillator state
+ * @param data Buffer of BLOCK_LEN samples to be filled with the oscillator waveform in Q0.15 format
+ */
+inline static void calcOscPinkNoiseBlock(
+                                         OscPinkNoiseState * const state,
+                                         _Q15 * data)
+{
+    checkRandState(&state->rand);
+
+    // Cache states and pointers for use with inline assembly
+    uint16_t state1Low = state->rand.state1.low;
+    uint16_t state1High = state->rand.state1.high;
+    uint16_t state2Low = state->rand.state2.low;
+    uint16_t state2High = state->rand.state2.high;
+    uint16_t counter = state->counter;
+    _Q15 sum = state->sum;
+    _Q15 * rows = state->rows;
+
+    __asm__ volatile(
+            "\
+        dec2    %[rows], %[rows]                                                ;Rewind rows pointer by one row, row index is 1-based \n \
+                                                                                ;\n \
+    ;Start processing loop                                                      ;\n \
+        do #%[Len]-1, CalcPinkNoise_%=                                          ;\n \
+                                                                                ;\n \
+    ;Update one row with new random value                                       ;\n \
+        xor     %[s2L], %[s1L], %[s1L]                                          ;state1 ^= state2 (low word) \n \
+        xor     %[s2H], %[s1H], %[s1H]                                          ;state1 ^= state2 (high word) \n \
+        add     %[s1L], %[s2L], %[s2L]                                          ;state2 += state1 (low word) \n \
+        addc    %[s1H], %[s2H], %[s2H]                                          ;state2 += state1 (high word) \n \
+        inc     %[cnt], %[cnt]                                                  ;Increment sample counter \n \
+        bset    %[cnt], #14                                                     ;Limit row index to NOF_PINK_NOISE_ROWS \n \
+        ff1r    %[cnt], w5                                                      ;w5 = row index = trailing zeros of counter + 1 (1 ... 15) \n \
+        sl      w5, #1, w5                                                      ;Convert row index to byte offset \n \
+        asr     %[s2H], #4, w4                                                  ;w4 = new row value (scaled by 1/16), no w5 stall \n \
+        mov     [%[rows]+w5], w6                                                ;w6 = old row value \n \
+        mov     w4, [%[rows]+w5]                                                ;Store new row value \n \
+        sub     %[sum], w6, %[sum]                                              ;sum -= old row value \n \
+        add     %[sum], w4, %[sum]                                              ;sum += new row value \n \
+                                                                                ;\n \
+    ;Add white noise value                                                      ;\n \
+        xor     %[s2L], %[s1L], %[s1L]                                          ;state1 ^= state2 (low word) \n \
+        xor     %[s2H], %[s1H], %[s1H]                                          ;state1 ^= state2 (high word) \n \
+        add     %[s1L], %[s2L], %[s2L]                                          ;state2 += state1 (low word) \n \
+        addc    %[s1H], %[s2H], %[s2H]                                          ;state2 += state1 (high word) \n \
+        asr     %[s2H], #4, w4                                                  ;w4 = white noise value (scaled by 1/16) \n \
+                                                                                ;\n \
+    CalcPinkNoise_%=:                                                           ;\n \
+        add     %[sum], w4, [%[x]++]                                            ;Store sum + white noise value in x, increment x pointer \n \
+                                                                                ;\n \
+        ; 3 + 19N cycles total"
+            : [x]"+r"(data), [rows]"+r"(rows), [cnt]"+r"(counter), [sum]"+r"(sum), [s1L]"+r"(state1Low), [s1H]"+r"(state1High), [s2L]"+r"(state2Low), [s2H]"+r"(state2High) /*out*/
+            : [Len]"i"(BLOCK_LEN) /*in*/
+            : "w4", "w5", "w6" /*clobbered*/
+            );
+
+    // Write back state
+    state->rand.state1.low = state1Low;
+    state->rand.state1.high = state1High;
+    state->rand.state2.low = state2Low;
+    state->rand.state2.high = state2High;
+    state->counter = counter;
+    state->sum = sum;
+}
+
+#endif
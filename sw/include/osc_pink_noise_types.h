@@ -0,0 +1,51 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file osc_pink_noise_types.h
+ * @brief Definition of pink noise oscillator types
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef OSC_PINK_NOISE_TYPES_H
+#define	OSC_PINK_NOISE_TYPES_H
+
+#include "fp_lib_types.h"
+#include "rand_types.h"
+#include <stdint.h>
+
+/// Number of Voss-McCartney rows, one additional white noise source is added every sample
+#define NOF_PINK_NOISE_ROWS 15
+
+/// Pink noise oscillator state
+typedef struct
+{
+    /// Voss-McCartney row values, row k is updated every 2^(k+1) samples (last row every 2^14 samples)
+    _Q15 rows[NOF_PINK_NOISE_ROWS];
+
+    /// Running sum of all row values
+    _Q15 sum;
+
+    /// Sample counter selecting the row to be updated
+    uint16_t counter;
+
+    /// Pseudo-random number generator state
+    RandState rand;
+} OscPinkNoiseState;
+
+#endif
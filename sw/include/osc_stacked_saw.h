@@ -29,6 +29,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SVF_2Pole.h"
 #include "fp_lib_types.h"
 #include "fp_lib_def.h"
+#include "param_cache.h"
 #include <stdint.h>
 
 /**
@@ -97,6 +98,37 @@ inline static void calcOscStackedSawParams(
                params->filterCoeffs2);
 }
 
+/**
+ * @brief Calculate parameters for stacked saw oscillator with change detection
+ * 
+ * Parameters are only recalculated if any input has changed since the last call
+ * @param note Note on MIDI scale given in half-cents
+ * @param freq Normalized oscillator frequency in Q0.32 format
+ * @param shape1 The shape1 parameter in Q0.16 format translates into a side-oscillator detune
+ * @param shape2 The shape2 parameter in Q0.16 format translates into a center/side-oscillator mixing ratio
+ * @param cache Struct holding the parameter cache
+ * @param params Struct holding stacked saw oscillator parameters
+ */
+inline static void calcOscStackedSawParamsCached(
+                                                 const int16_t note,
+                                                 const _Q32 freq,
+                                                 const _Q16 shape1,
+                                                 const _Q16 shape2,
+                                                 ParamCache * const cache,
+                                                 OscStackedSawParams * const params)
+{
+    const uint16_t inputs[] = {note, (uint16_t) freq, (uint16_t) (freq >> 16), shape1, shape2};
+    if (updateParamCache(cache, inputs, 5))
+    {
+        calcOscStackedSawParams(
+                                note,
+                                freq,
+                                shape1,
+                                shape2,
+                                params);
+    }
+}
+
 /**
  * @brief Calculate one sample of stacked saw oscillator waveform
  * 
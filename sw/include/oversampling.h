@@ -0,0 +1,76 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file oversampling.h
+ * @brief Function prototypes for oversampling framework
+ * 
+ * Any block processing can be oversampled by wrapping it in calcOversamplingUp() and calcOversamplingDown().
+ * Each 2x oversampling stage consists of a polyphase halfband interpolator and decimator (see halfband.h).
+ * The filter cost is ~12 cycles per input sample of each interpolator stage and ~14 cycles per output sample of
+ * each decimator stage plus ~50 cycles per stage, i.e. ~26 cycles per base rate sample for 2x and ~78 cycles per
+ * base rate sample for 4x oversampling
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#ifndef OVERSAMPLING_H
+#define OVERSAMPLING_H
+
+#include "oversampling_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Upsampling of one audio channel
+ * @param factor Oversampling factor
+ * @param coeffs Halfband filter coefficients as copied by copyHalfbandCoeffs() allocated in y memory
+ * @param state Struct holding oversampling state
+ * @param xBuffer Work buffer of size >= (len << factor) + HALFBAND_INTERP_HISTORY_LEN allocated in x memory
+ * @param input Input buffer of len samples at base rate
+ * @param oversampled Output buffer of len << factor samples, may be the same as input buffer
+ * @param len Number of samples at base rate
+ */
+void calcOversamplingUp(
+        const OversamplingFactor factor,
+        const _Q15 * const coeffs,
+        OversamplingState * const state,
+        _Q15 * const xBuffer,
+        const _Q15 * const input,
+        _Q15 * const oversampled,
+        const uint16_t len);
+
+/**
+ * @brief Downsampling of one audio channel
+ * @param factor Oversampling factor
+ * @param coeffs Halfband filter coefficients as copied by copyHalfbandCoeffs() allocated in y memory
+ * @param state Struct holding oversampling state
+ * @param xBuffer Work buffer of size >= (len << factor) + HALFBAND_DECIM_HISTORY_LEN allocated in x memory
+ * @param oversampled Input buffer of len << factor samples, will be overwritten
+ * @param output Output buffer of len samples at base rate, may be the same as oversampled buffer
+ * @param len Number of samples at base rate
+ */
+void calcOversamplingDown(
+        const OversamplingFactor factor,
+        const _Q15 * const coeffs,
+        OversamplingState * const state,
+        _Q15 * const xBuffer,
+        _Q15 * const oversampled,
+        _Q15 * const output,
+        const uint16_t len);
+
+#endif
@@ -0,0 +1,54 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file oversampling_types.h
+ * @brief Type definitions for oversampling framework
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#ifndef OVERSAMPLING_TYPES_H
+#define OVERSAMPLING_TYPES_H
+
+#include "halfband_types.h"
+
+/// Maximum number of 2x oversampling stages
+#define NOF_OVERSAMPLING_STAGES 2
+
+/**
+ * Oversampling factor
+ * The enum value is the power of two of the oversampling factor, i.e. the number of 2x oversampling stages
+ */
+typedef enum
+{
+    OVERSAMPLING_NONE = 0, // Processing runs at base sample rate
+    OVERSAMPLING_2X,       // Processing runs at 2x sample rate
+    OVERSAMPLING_4X        // Processing runs at 4x sample rate
+} OversamplingFactor;
+
+/// Oversampling state of one audio channel
+typedef struct
+{
+    /// Interpolator state of each oversampling stage
+    HalfbandInterpState interp[NOF_OVERSAMPLING_STAGES];
+
+    /// Decimator state of each oversampling stage
+    HalfbandDecimState decim[NOF_OVERSAMPLING_STAGES];
+} OversamplingState;
+
+#endif
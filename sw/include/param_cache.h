@@ -0,0 +1,74 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file param_cache.h
+ * @brief Change detection for parameter calculation
+ * 
+ * Parameter and coefficient calculations are skipped as long as their inputs do not change.
+ * A ParamCache must be zero-initialized or invalidated before first use.
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef PARAM_CACHE_H
+#define	PARAM_CACHE_H
+
+#include "param_cache_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Invalidate parameter cache
+ * 
+ * The next call of updateParamCache() will report a change regardless of the inputs
+ * @param cache Struct holding the parameter cache
+ */
+inline static void invalidateParamCache(ParamCache * const cache)
+{
+    cache->valid = false;
+}
+
+/**
+ * @brief Compare inputs against the parameter cache and update the cache
+ * @param cache Struct holding the parameter cache
+ * @param inputs Current input values
+ * @param nofInputs Number of input values (nofInputs <= PARAM_CACHE_SIZE)
+ * @return true if any input has changed since the last call or the cache was invalid, i.e. parameters need to be recalculated
+ */
+inline static bool updateParamCache(
+                                    ParamCache * const cache,
+                                    const uint16_t * const inputs,
+                                    const uint16_t nofInputs)
+{
+    bool changed = !cache->valid;
+    
+    for (uint16_t cInput = 0; cInput < nofInputs; ++cInput)
+    {
+        if (cache->inputs[cInput] != inputs[cInput])
+        {
+            cache->inputs[cInput] = inputs[cInput];
+            changed = true;
+        }
+    }
+    
+    cache->valid = true;
+    
+    return changed;
+}
+
+#endif
@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file param_cache_types.h
+ * @brief Definition of parameter cache types
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef PARAM_CACHE_TYPES_H
+#define	PARAM_CACHE_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/// Maximum number of input words held by a parameter cache
+#define PARAM_CACHE_SIZE 6
+
+/// Parameter cache holding the inputs of the last parameter calculation
+typedef struct
+{
+    /// Flag indicating the cached inputs are valid
+    bool valid;
+    
+    /// Cached input values
+    uint16_t inputs[PARAM_CACHE_SIZE];
+} ParamCache;
+
+#endif
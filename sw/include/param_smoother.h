@@ -0,0 +1,168 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file param_smoother.h
+ * @brief Parameter smoothing
+ * 
+ * Parameter changes are smoothed over several blocks to avoid zipper noise. The smoothed value can either be applied
+ * block-constant (updateParamSmoother()), e.g. for AmpParams.gain or StereoDelayParams.feedback, or as per-sample
+ * ramp (updateParamSmootherBlock()), e.g. as source buffer for evalModMatrixBlock(). As long as a parameter does not change, the smoother is settled and costs one comparison.
+ * Parameter values are passed as raw 16-bit words, e.g. (uint16_t) params->mix for a Q0.15 parameter.
+ * A ParamSmoother must be initialized by initParamSmoother() before first use.
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef PARAM_SMOOTHER_H
+#define	PARAM_SMOOTHER_H
+
+#include "param_smoother_types.h"
+#include "ramp.h"
+#include "fp_lib_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Get the offset between raw parameter values and the unsigned smoother representation
+ * @param params Struct holding parameter smoother parameters
+ * @return Offset to be applied by XOR
+ */
+inline static uint16_t getParamSmootherOffset(const ParamSmootherParams * const params)
+{
+    return params->isSigned ? 0x8000 : 0;
+}
+
+/**
+ * @brief Initialize parameter smoother
+ * 
+ * The smoother is settled at the initial value
+ * @param params Struct holding parameter smoother parameters
+ * @param smoother Struct holding parameter smoother state
+ * @param value Initial parameter value
+ */
+inline static void initParamSmoother(
+                                     const ParamSmootherParams * const params,
+                                     ParamSmoother * const smoother,
+                                     const uint16_t value)
+{
+    smoother->value = (uint32_t) (value ^ getParamSmootherOffset(params)) << 16;
+    smoother->increment = 0;
+    smoother->target = value;
+    smoother->remaining = 0;
+    smoother->settled = true;
+}
+
+/**
+ * @brief Update parameter smoother once per block
+ * @param params Struct holding parameter smoother parameters
+ * @param smoother Struct holding parameter smoother state
+ * @param target Target parameter value
+ * @return Smoothed parameter value
+ */
+inline static uint16_t updateParamSmoother(
+                                           const ParamSmootherParams * const params,
+                                           ParamSmoother * const smoother,
+                                           const uint16_t target)
+{
+    const uint16_t offset = getParamSmootherOffset(params);
+    const int32_t targetValue = target ^ offset;
+
+    // Start smoothing on target change
+    if (target != smoother->target)
+    {
+        smoother->target = target;
+        smoother->settled = false;
+
+        // Linear ramp reaches the target exactly after 2^blocksPow2 updates
+        const int32_t diff = targetValue - (int32_t) (smoother->value >> 16);
+        smoother->increment = diff * (1L << (16 - params->blocksPow2));
+        smoother->remaining = 1u << params->blocksPow2;
+    }
+
+    // Settled parameters cost nothing
+    if (smoother->settled)
+    {
+        return target;
+    }
+
+    if (params->mode == PARAM_SMOOTHER_LINEAR)
+    {
+        smoother->value += smoother->increment;
+        smoother->settled = --smoother->remaining == 0;
+    }
+    else
+    {
+        // Weight difference with rate (difference is halved to fit into 16 bit). The product is doubled in unsigned
+        // arithmetic, since it may exceed the signed 32-bit range. The sum wraps around as intended
+        const int32_t diff = targetValue - (int32_t) (smoother->value >> 16);
+        smoother->value += (uint32_t) __builtin_mulsu(diff >> 1, params->rate) << 1;
+        smoother->settled = (diff >= -1) && (diff <= 1);
+    }
+
+    if (smoother->settled)
+    {
+        smoother->value = (uint32_t) targetValue << 16;
+    }
+
+    return (smoother->value >> 16) ^ offset;
+}
+
+/**
+ * @brief Update parameter smoother once per block and calculate a per-sample ramp
+ * 
+ * The ramp runs linearly from the last to the updated smoothed value, the last sample equals the value
+ * updateParamSmoother() would return
+ * @param params Struct holding parameter smoother parameters
+ * @param smoother Struct holding parameter smoother state
+ * @param target Target parameter value
+ * @param data Buffer of BLOCK_LEN samples to be filled with the ramp
+ * @return true if a ramp has been calculated, false if the smoother is settled (data is not written, use the
+ * block-constant target value instead)
+ */
+inline static bool updateParamSmootherBlock(
+                                            const ParamSmootherParams * const params,
+                                            ParamSmoother * const smoother,
+                                            const uint16_t target,
+                                            uint16_t * data)
+{
+    if (smoother->settled && (target == smoother->target))
+    {
+        return false;
+    }
+
+    const uint32_t lastValue = smoother->value;
+    const uint16_t value = updateParamSmoother(
+                                               params,
+                                               smoother,
+                                               target);
+
+    // Spread the change evenly over the block (halved change in Q16.16 format). The ramp starts from the raw
+    // representation, the offset does not change the differences
+    calcRampBlock(
+            lastValue ^ ((uint32_t) getParamSmootherOffset(params) << 16),
+            calcRampIncrement((int32_t) (smoother->value >> 1) - (int32_t) (lastValue >> 1)),
+            data);
+
+    // Last sample equals the updated smoothed value
+    data[BLOCK_LEN - 1] = value;
+
+    return true;
+}
+
+#endif
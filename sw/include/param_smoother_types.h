@@ -0,0 +1,73 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file param_smoother_types.h
+ * @brief Definition of parameter smoother types
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef PARAM_SMOOTHER_TYPES_H
+#define	PARAM_SMOOTHER_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/// Parameter smoother mode
+typedef enum
+{
+    PARAM_SMOOTHER_ONE_POLE = 0, // One-pole smoothing, the speed is proportional to the remaining difference
+    PARAM_SMOOTHER_LINEAR        // Linear ramp to the target value over a fixed number of blocks
+} ParamSmootherMode;
+
+/// Parameter smoother parameters
+typedef struct
+{
+    /// Smoother mode
+    ParamSmootherMode mode;
+
+    /// Weight of the remaining difference per update in Q0.16 format (PARAM_SMOOTHER_ONE_POLE, rate > 0)
+    uint16_t rate;
+
+    /// Ramp length is 2^blocksPow2 updates (PARAM_SMOOTHER_LINEAR, 1 <= blocksPow2 <= 15)
+    uint16_t blocksPow2;
+
+    /// Flag indicating the smoothed parameter is signed (e.g. Q0.15), otherwise unsigned (e.g. Q0.16)
+    bool isSigned;
+} ParamSmootherParams;
+
+/// Parameter smoother state
+typedef struct
+{
+    /// Current value in Q16.16 format, signed parameters are stored offset by 0x8000
+    uint32_t value;
+
+    /// Increment per update of the current linear ramp
+    int32_t increment;
+
+    /// Target value
+    uint16_t target;
+
+    /// Remaining number of updates of the current linear ramp
+    uint16_t remaining;
+
+    /// Flag indicating the value has reached the target, i.e. no smoothing is needed
+    bool settled;
+} ParamSmoother;
+
+#endif
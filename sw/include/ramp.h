@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ramp.h
+ * @brief Implementation of linear per-sample ramps
+ * 
+ * Block-rate values (glide, envelopes, smoothed parameters) are spread over the block by a linear ramp calculated
+ * with a 32-bit accumulator. The ramp increment is calculated by multiplication, i.e. without per-block division
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#ifndef RAMP_H
+#define	RAMP_H
+
+#include "fp_lib_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+
+/// Reciprocal of the block length in Q0.16 format (BLOCK_LEN >= 2)
+#define RAMP_BLOCK_LEN_RECIPROCAL ((uint16_t) (65536UL / BLOCK_LEN))
+
+/**
+ * @brief Calculate the per-sample increment of a ramp
+ * 
+ * The change is given halved, so changes of the full 16-bit range (e.g. from 0 to 0xFFFF) can be represented
+ * @param halfStep Change of the value over one block in Q16.16 format, divided by 2
+ * @return Increment per sample in Q16.16 format (rounded down)
+ */
+inline static int32_t calcRampIncrement(const int32_t halfStep)
+{
+    // Increment = 2 * halfStep * (1 / BLOCK_LEN), calculated by two 16x16 multiplications
+    const Long step = {.value = halfStep};
+    return __builtin_mulsu(step.high, RAMP_BLOCK_LEN_RECIPROCAL) * 2
+            + (int32_t) (__builtin_muluu(step.low, RAMP_BLOCK_LEN_RECIPROCAL) >> 15);
+}
+
+/**
+ * @brief Calculate a linear ramp of BLOCK_LEN samples
+ * 
+ * The first sample is start + increment, i.e. the ramp ends (approximately) at the value after one block
+ * @param start Start value in Q16.16 format (high word is the 16-bit sample value)
+ * @param increment Increment per sample in Q16.16 format, see calcRampIncrement()
+ * @param data Buffer of BLOCK_LEN samples to be filled with the high words of the ramp
+ */
+inline static void calcRampBlock(
+                                 const uint32_t start,
+                                 const int32_t increment,
+                                 uint16_t * data)
+{
+    const Long inc = {.value = increment};
+    uint16_t rampLow = start;
+    uint16_t rampHigh = start >> 16;
+
+    __asm__ volatile(
+            "\
+        do #%[Len]-1, CalcRampBlock_%=                                          ;\n \
+        add     %[incL], %[rampL], %[rampL]                                     ;ramp += increment (low word) \n \
+        addc    %[incH], %[rampH], %[rampH]                                     ;ramp += increment (high word) \n \
+    CalcRampBlock_%=:                                                           ;\n \
+        mov     %[rampH], [%[x]++]                                              ;Store high word of ramp in x, increment x pointer \n \
+                                                                                ;\n \
+        ; 2 + 3N cycles total"
+            : [x]"+r"(data), [rampL]"+r"(rampLow), [rampH]"+r"(rampHigh) /*out*/
+            : [incL]"r"(inc.low), [incH]"r"(inc.high), [Len]"i"(BLOCK_LEN) /*in*/
+            : /*clobbered*/
+            );
+}
+
+#endif
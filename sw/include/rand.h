@@ -25,26 +25,104 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef RAND_H
 #define	RAND_H
 
+#include "rand_types.h"
 #include "fp_lib_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+
+/**
+ * @brief Initialize pseudo-random number generator state
+ *
+ * The same seed always produces the same sequence. The seed is applied to the low word of the state, since the
+ * generator only carries differences toward higher bits. Different seeds produce different sequences, but they are
+ * not guaranteed to be statistically independent
+ * @param state Struct holding pseudo-random number generator state
+ * @param seed Seed value
+ */
+static inline void initRandState(
+                                 RandState * const state,
+                                 const uint16_t seed)
+{
+    state->state1.value = 0x67452301 ^ seed;
+    state->state2.value = 0xefcdab89;
+}
+
+/**
+ * @brief Check pseudo-random number generator state
+ *
+ * A zero-initialized state would produce a constant zero output, so it is replaced by the default seed
+ * @param state Struct holding pseudo-random number generator state
+ */
+static inline void checkRandState(RandState * const state)
+{
+    if ((state->state1.value | state->state2.value) == 0)
+    {
+        initRandState(
+                      state,
+                      0);
+    }
+}
 
 /**
  * @brief Generate a pseudo-random number in Q0.15 format
  * 
  * This function uses a 32-bit random generator as described here: https://www.musicdsp.org/en/latest/Synthesis/216-fast-whitenoise-generator.html
+ * @note The state is not checked to keep this function branch-free, it must be initialized by initRandState() or
+ * checked by checkRandState() once per block
+ * @param state Struct holding pseudo-random number generator state
  * @return Pseudo-random number in Q0.15 format
  */
-static inline _Q15 rand()
+static inline _Q15 randSample(RandState * const state)
 {
-    // Static initialization of PN generator state
-    static Long state1 = {.value = 0x67452301};
-    static Long state2 = {.value = 0xefcdab89};
-
     // Update PN generator state
-    state1.value ^= state2.value;
-    state2.value += state1.value;
+    state->state1.value ^= state->state2.value;
+    state->state2.value += state->state1.value;
     
     // Return high word
-    return state2.high;
+    return state->state2.high;
+}
+
+/**
+ * @brief Generate one block of pseudo-random numbers in Q0.15 format
+ *
+ * This function uses a 32-bit random generator as described here: https://www.musicdsp.org/en/latest/Synthesis/216-fast-whitenoise-generator.html
+ * @param state Struct holding pseudo-random number generator state
+ * @param data Buffer of BLOCK_LEN samples to be filled with pseudo-random numbers
+ */
+static inline void randBlock(
+                             RandState * const state,
+                             _Q15 * data)
+{
+    checkRandState(state);
+
+    // Cache state for use with inline assembly
+    uint16_t state1Low = state->state1.low;
+    uint16_t state1High = state->state1.high;
+    uint16_t state2Low = state->state2.low;
+    uint16_t state2High = state->state2.high;
+
+    __asm__ volatile(
+            "\
+    ;Start processing loop                                                      ;\n \
+        do #%[Len]-1, RandBlock_%=                                              ;\n \
+        xor     %[s2L], %[s1L], %[s1L]                                          ;state1 ^= state2 (low word) \n \
+        xor     %[s2H], %[s1H], %[s1H]                                          ;state1 ^= state2 (high word) \n \
+        add     %[s1L], %[s2L], %[s2L]                                          ;state2 += state1 (low word) \n \
+        addc    %[s1H], %[s2H], %[s2H]                                          ;state2 += state1 (high word) \n \
+    RandBlock_%=:                                                               ;\n \
+        mov     %[s2H], [%[x]++]                                                ;Store high word of state2 in x, increment x pointer \n \
+                                                                                ;\n \
+        ; 2 + 5N cycles total"
+            : [x]"+r"(data), [s1L]"+r"(state1Low), [s1H]"+r"(state1High), [s2L]"+r"(state2Low), [s2H]"+r"(state2High) /*out*/
+            : [Len]"i"(BLOCK_LEN) /*in*/
+            : /*clobbered*/
+            );
+
+    // Write back state
+    state->state1.low = state1Low;
+    state->state1.high = state1High;
+    state->state2.low = state2Low;
+    state->state2.high = state2High;
 }
 
 #endif
@@ -27,6 +27,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <stdint.h>
 #include "fp_lib_types.h"
+#include "transport_types.h"
 
 /// Stereo chorus parameters
 typedef struct
@@ -45,6 +46,12 @@ typedef struct
     
     /// Chorus mix
     _Q15 mix;
+
+    /// Transport clock for tempo-synced modulation, NULL for free-running modulation at chorus modulation rate
+    const TransportState * transport;
+
+    /// Number of modulation cycles per beat in Q16.16 format (needed for tempo-synced modulation)
+    uint32_t syncRatio;
 } ChorusParams;
 
 #endif
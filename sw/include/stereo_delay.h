@@ -30,6 +30,11 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 /**
  * @brief Add delay to stereo signal
+ * @note The delay line buffers hold BLOCK_LEN >> params->rate samples, i.e. the delay line runs at reduced sample rate
+ * for STEREO_DELAY_RATE_HALF and STEREO_DELAY_RATE_QUARTER. This multiplies the maximum delay time for a given delay
+ * memory by 2 or 4 at the cost of bandwidth. The brightness filter cut-off is compensated for the delay line rate
+ * @note The delay time is given by the caller's delay line memory management. For tempo-synced delay times the number
+ * of delay blocks can be taken from calcTransportDelayBlocks() in transport.h
  * @param params Struct holding stereo delay parameters
  * @param state Struct holding stereo delay state
  * @param delayLineLeft Input/output buffer for left delay line
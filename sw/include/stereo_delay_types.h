@@ -0,0 +1,78 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file stereo_delay_types.h
+ * @brief Type definitions for stereo delay effect
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef STEREO_DELAY_TYPES_H
+#define	STEREO_DELAY_TYPES_H
+
+#include <stdint.h>
+#include "fp_lib_types.h"
+#include "iir_1pole_types.h"
+
+/**
+ * Sample rate of the delay line
+ * The enum value is the power of two of the decimation factor
+ */
+typedef enum
+{
+    STEREO_DELAY_RATE_FULL = 0, // Delay line runs at full sample rate, BLOCK_LEN samples per block
+    STEREO_DELAY_RATE_HALF,     // Delay line runs at 1/2 sample rate, BLOCK_LEN/2 samples per block
+    STEREO_DELAY_RATE_QUARTER   // Delay line runs at 1/4 sample rate, BLOCK_LEN/4 samples per block
+} StereoDelayRate;
+
+/// Stereo delay state
+typedef struct
+{
+    /// Brightness filter state for left stereo channel
+    IIROnePoleState filterStateLeft;
+
+    /// Brightness filter state for right stereo channel
+    IIROnePoleState filterStateRight;
+
+    /// Last delay line output for left stereo channel at half scale (needed for interpolation at reduced rate)
+    _Q15 lastLeft;
+
+    /// Last delay line output for right stereo channel at half scale (needed for interpolation at reduced rate)
+    _Q15 lastRight;
+} StereoDelayState;
+
+/// Stereo delay parameters
+typedef struct
+{
+    /// Feedback amount
+    _Q15 feedback;
+
+    /// Dry/Wet mix
+    _Q15 mix;
+
+    /// Brightness of the feedback path (0 = darkest ... 1 = brightest)
+    _Q16 brightness;
+
+    /// Stereo spread of the feedback path (0 = no spread ... 1 = stereo inversion/ping-pong)
+    _Q15 spread;
+
+    /// Sample rate of the delay line
+    StereoDelayRate rate;
+} StereoDelayParams;
+
+#endif
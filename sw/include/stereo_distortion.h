@@ -17,7 +17,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 /**
  * @file stereo_distortion.h
- * @brief Impementation of stereo chorus effect
+ * @brief Implementation of stereo distortion effect
  * 
  * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
  */
@@ -31,22 +31,23 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include "fp_lib_types.h"
 #include "fp_lib_typeconv.h"
 #include "fp_lib_mul.h"
+#include "param_cache.h"
 
 /**
- * @brief Add chorus effect to stereo signal
- * @note The working length of this function is BLOCK_LEN
- * @param params Struct holding stereo chorus parameters
- * @param dataL Audio data for left stereo channel
- * @param dataR Audio data for right stereo channel
+ * @brief In-place calculation of distortion
+ * @param params Struct holding distortion parameters
+ * @param data Audio data
+ * @param len Number of samples
  */
-static inline void addStereoDistortion(
+static inline void calcDistortion(
         const DistortionParams * const params,
-        _Q15 * data)
+        _Q15 * data,
+        const uint16_t len)
 {
     const _Q15 hardShape = mul_Q15_Q15(params->drive, params->shape);
     const _Q15 softShape = params->drive - hardShape;
     
-    for (uint16_t cSample = 0; cSample < BLOCK_LEN * 2; ++cSample)
+    for (uint16_t cSample = 0; cSample < len; ++cSample)
     {
    // Hard clipping
     volatile register int acc asm("A");
@@ -63,4 +64,161 @@ static inline void addStereoDistortion(
     }
 }
 
+/**
+ * @brief Add distortion effect to stereo signal
+ * @note The working length of this function is BLOCK_LEN
+ * @param params Struct holding distortion parameters
+ * @param data Audio data for both stereo channels (2 * BLOCK_LEN samples, left channel block followed by right
+ * channel block)
+ */
+static inline void addStereoDistortion(
+        const DistortionParams * const params,
+        _Q15 * data)
+{
+    calcDistortion(
+            params,
+            data,
+            BLOCK_LEN * 2);
+}
+
+/**
+ * @brief Calculation of waveshaper curve table for given distortion parameters
+ *
+ * The curve table holds the distortion curve of calcDistortion() sampled at 257 equidistant input values from -1 to 1
+ * @param params Struct holding distortion parameters
+ * @param curve Curve table of size DISTORTION_CURVE_LEN
+ */
+static inline void calcDistortionCurve(
+        const DistortionParams * const params,
+        _Q15 * const curve)
+{
+    for (uint16_t cEntry = 0; cEntry < DISTORTION_CURVE_LEN - 1; ++cEntry)
+    {
+        curve[cEntry] = (cEntry << 8) ^ 0x8000;
+    }
+    curve[DISTORTION_CURVE_LEN - 1] = 0x7FFF;
+
+    calcDistortion(
+            params,
+            curve,
+            DISTORTION_CURVE_LEN);
+}
+
+/**
+ * @brief In-place calculation of table-driven waveshaper with dry/wet mix
+ *
+ * The curve table is linearly interpolated like interpLUT_256_Q15(), so any curve (e.g. tube, diode or wavefolder)
+ * costs the same
+ * @param curve Curve table of size DISTORTION_CURVE_LEN (entry 0 = output for input -1, entry 256 = output for input 1)
+ * @param mix Dry/Wet mix in Q0.15 format
+ * @param data Audio data
+ * @param len Number of samples
+ */
+static inline void calcWaveshaper(
+        const _Q15 * const curve,
+        const _Q15 mix,
+        _Q15 * data,
+        const uint16_t len)
+{
+    _Q15 * entry;
+    _Q15 value;
+    __asm__ volatile(
+            "\
+        mov     %[mix], w5                                                      ;w5 = mix \n \
+                                                                                ;\n \
+    ;Start processing loop                                                      ;\n \
+        do %[len], Waveshaper_%=                                                ;\n \
+                                                                                ;\n \
+    ;Split table position into index and fraction                              ;\n \
+        mov     [%[x]], w4                                                      ;w4 = dry sample \n \
+        xor     w4, %[msb], w7                                                  ;w7 = dry sample + 1 (Q1.15 --> Q0.16) \n \
+        lsr     w7, #7, %[entry]                                                ;entry = 2 * index \n \
+        bclr    %[entry], #0                                                    ;Clear fractional bit \n \
+        add     %[curve], %[entry], %[entry]                                    ;entry = &curve[index] \n \
+        sl      w7, #7, w6                                                      ;w6 = fraction (Q0.8 --> Q0.15) \n \
+        bclr    w6, #15                                                         ;Clear integer bit \n \
+                                                                                ;\n \
+    ;Interpolate curve table: wet = curve[index] + fraction * (curve[index + 1] - curve[index]) ;\n \
+        mov     [%[entry]++], %[value]                                          ;value = curve[index] \n \
+        mov     [%[entry]], w7                                                  ;w7 = curve[index + 1] \n \
+        sub     w7, %[value], w7                                                ;w7 = curve[index + 1] - curve[index] \n \
+        lac     %[value], #0, A                                                 ;AccA = curve[index] \n \
+        mac     w6 * w7, A                                                      ;AccA += fraction * (curve[index + 1] - curve[index]) \n \
+        sac.r   A, #0, w7                                                       ;w7 = wet sample \n \
+                                                                                ;\n \
+    ;Mix: x = (1 - mix) * dry + mix * wet                                       ;\n \
+        lac     w4, #0, A                                                       ;AccA = dry \n \
+        msc     w4 * w5, A                                                      ;AccA -= dry * mix \n \
+        mac     w5 * w7, A                                                      ;AccA += wet * mix \n \
+                                                                                ;\n \
+    Waveshaper_%=:                                                              ;\n \
+        sac.r   A, #0, [%[x]++]                                                 ;Store AccA in x, increment x pointer \n \
+                                                                                ;\n \
+        ; 3 + 17N cycles total"
+            : [x]"+r"(data), [entry]"=&r"(entry), [value]"=&r"(value) /*out*/
+            : [len]"r"(len - 1), [curve]"r"(curve), [mix]"r"(mix), [msb]"r"(0x8000) /*in*/
+            : "w4", "w5", "w6", "w7" /*clobbered*/
+            );
+}
+
+/**
+ * @brief Add table-driven distortion effect to stereo signal
+ *
+ * Cheaper alternative to addStereoDistortion(). The distortion curve is only recalculated if drive or shape
+ * have changed, dry/wet mix is applied in the same pass
+ * @note The working length of this function is BLOCK_LEN
+ * @note The state must be zero-initialized before first use
+ * @param params Struct holding distortion parameters
+ * @param state Struct holding distortion state
+ * @param data Audio data for both stereo channels (2 * BLOCK_LEN samples, left channel block followed by right
+ * channel block)
+ */
+static inline void addStereoWaveshaper(
+        const DistortionParams * const params,
+        DistortionState * const state,
+        _Q15 * data)
+{
+    const uint16_t inputs[] = {params->drive, params->shape};
+    if (updateParamCache(&state->cache, inputs, 2))
+    {
+        calcDistortionCurve(
+                params,
+                state->curve);
+    }
+
+    calcWaveshaper(
+            state->curve,
+            convert_Q16_Q15(params->mix),
+            data,
+            BLOCK_LEN * 2);
+}
+
+/**
+ * @brief Add oversampled distortion effect to stereo signal
+ *
+ * The distortion is calculated at the sample rate selected by params->oversampling to reduce aliasing.
+ * Each 2x oversampling stage consists of a polyphase halfband interpolator and decimator.
+ * The filter cost per stereo channel is ~26 cycles per sample for 2x and ~78 cycles per sample for 4x oversampling,
+ * the distortion itself is calculated for 2 or 4 times the number of samples
+ * @note The working length of this function is BLOCK_LEN
+ * @param params Struct holding distortion parameters
+ * @param state Struct holding distortion state
+ * @param xBuffer Work buffer of size >= 4 * BLOCK_LEN + HALFBAND_DECIM_HISTORY_LEN allocated in x memory
+ * @param yBuffer Work buffer of size >= HALFBAND_COEFF_BUFFER_LEN allocated in y memory
+ * @param oversampled Work buffer of size >= 4 * BLOCK_LEN for oversampled audio data
+        _Q15 * const data)
+{
+    if (params->oversampling == DISTORTION_OVERSAMPLING_NONE)
+    {
+        addStereoDistortion(params, data);
+        return;
+    }
+
+        const DistortionParams * const params,
+        DistortionState * const state,
+        _Q15 * const xBuffer,
+        _Q15 * const yBuffer,
+        _Q15 * const oversampled,
+        _Q15 * const data);
+
 #endif
\ No newline at end of file
@@ -17,7 +17,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 /**
  * @file stereo_distortion_types.h
- * @brief Impementation of stereo chorus effect
+ * @brief Type definitions for stereo distortion effect
  * 
  * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
  */
@@ -26,6 +26,40 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #define STEREO_DISTORTION_TYPES_H
 
 #include "fp_lib_types.h"
+#include "oversampling_types.h"
+#include "param_cache_types.h"
+
+/// Number of entries of the waveshaper curve table
+#define DISTORTION_CURVE_LEN 257
+
+/// Maximum number of 2x oversampling stages
+#define NOF_DISTORTION_OVERSAMPLING_STAGES NOF_OVERSAMPLING_STAGES
+
+/**
+ * Oversampling factor of the distortion
+ * The enum value is the power of two of the oversampling factor, i.e. the number of 2x oversampling stages
+ * (matches OversamplingFactor)
+ */
+typedef enum
+{
+    DISTORTION_OVERSAMPLING_NONE = 0, // Distortion runs at base sample rate
+    DISTORTION_OVERSAMPLING_2X,       // Distortion runs at 2x sample rate
+    DISTORTION_OVERSAMPLING_4X        // Distortion runs at 4x sample rate
+} DistortionOversampling;
+
+/// Distortion state (only needed for oversampling and waveshaper)
+typedef struct
+{
+    /// Waveshaper curve table
+    _Q15 curve[DISTORTION_CURVE_LEN];
+
+    /// Parameter cache for waveshaper curve calculation
+    ParamCache cache;
+
+
+    /// Oversampling state for left and right stereo channel
+    OversamplingState oversampling[2];
+} DistortionState;
 
 /// Distortion parameters
 typedef struct
@@ -36,7 +70,11 @@ typedef struct
     /// Shape of distortion curve (0 = soft ... 1 = hard)
     _Q15 shape;
     
+    /// Dry/Wet mix (only used by addStereoWaveshaper())
     _Q16 mix;
+
+    /// Oversampling factor (only used by addStereoDistortionOversampled())
+    DistortionOversampling oversampling;
 } DistortionParams;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file stereo_reverb.h
+ * @brief Function prototypes for stereo reverb effect
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef STEREO_REVERB_H
+#define	STEREO_REVERB_H
+
+#include "stereo_reverb_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Initialize stereo reverb state
+ *
+ * The caller-supplied memory is split up into the allpass diffusers and the delay lines of the feedback delay network.
+ * The room size scales with the amount of memory, e.g. 8192 words correspond to a longest delay line of ~50 ms @ 48 kHz
+ * @param state Struct holding stereo reverb state
+ * @param memory Delay memory, will be cleared
+ * @param size Size of delay memory in words
+ * @note size must be >= 32 * (BLOCK_LEN + 1), so that the shortest delay line holds at least one block (not checked)
+ */
+void initStereoReverb(
+        StereoReverbState * const state,
+        _Q15 * const memory,
+        const uint16_t size);
+
+/**
+ * @brief Add reverb to stereo signal
+ *
+ * Mono input is diffused by two allpass filters and fed into a 4-line feedback delay network with Householder
+ * feedback matrix and 1-pole damping in each line
+ * @note The working length of this function is BLOCK_LEN
+ * @note The processing cost is ~120 cycles per stereo sample plus ~150 cycles per block
+ * @param params Struct holding stereo reverb parameters
+ * @param state Struct holding stereo reverb state
+ * @param dataL Audio data for left stereo channel
+ * @param dataR Audio data for right stereo channel
+ */
+void addStereoReverb(
+        const StereoReverbParams * const params,
+        StereoReverbState * const state,
+        _Q15 * dataL,
+        _Q15 * dataR);
+
+#endif
@@ -0,0 +1,80 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file stereo_reverb_types.h
+ * @brief Type definitions for stereo reverb effect
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef STEREO_REVERB_TYPES_H
+#define	STEREO_REVERB_TYPES_H
+
+#include <stdint.h>
+#include "fp_lib_types.h"
+#include "iir_1pole_types.h"
+
+/// Number of input allpass diffusers
+#define NOF_REVERB_ALLPASS 2
+
+/// Number of delay lines in the feedback delay network
+#define NOF_REVERB_DELAY_LINES 4
+
+/// Reverb delay line (ring buffer in caller-supplied memory)
+typedef struct
+{
+    /// Pointer to delay line memory
+    _Q15 * buffer;
+
+    /// Delay line length in samples (>= BLOCK_LEN)
+    uint16_t len;
+
+    /// Current read/write position
+    uint16_t pos;
+} ReverbDelayLine;
+
+/// Stereo reverb state
+typedef struct
+{
+    /// Input allpass diffusers
+    ReverbDelayLine allpass[NOF_REVERB_ALLPASS];
+
+    /// Delay lines of the feedback delay network
+    ReverbDelayLine delayLine[NOF_REVERB_DELAY_LINES];
+
+    /// Damping filter state for each delay line
+    IIROnePoleState damping[NOF_REVERB_DELAY_LINES];
+} StereoReverbState;
+
+/// Stereo reverb parameters
+typedef struct
+{
+    /// Reverb decay, i.e. feedback gain of the delay network
+    _Q15 decay;
+
+    /// Brightness of the reverb tail (0 = darkest ... 1 = brightest)
+    _Q16 brightness;
+
+    /// Allpass diffusion amount
+    _Q15 diffusion;
+
+    /// Reverb mix
+    _Q15 mix;
+} StereoReverbParams;
+
+#endif
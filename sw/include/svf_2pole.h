@@ -30,6 +30,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include "fp_lib_interp.h"
 #include "fp_lib_typeconv.h"
 #include "svf_2pole_types.h"
+#include "param_cache.h"
 #include "block_len_def.h"
 
 /**
@@ -127,6 +128,31 @@ static inline void calcCoeffs(
     coeffs[3] = k;
 }
 
+/**
+ * @brief Calculation of SVF parameters with change detection
+ * 
+ * SVF parameters are only recalculated if note or resonance have changed since the last call
+ * @param note Filter frequency on MIDI note scale given in half-cents
+ * @param resonance Filter resonance in Q0.16 format
+ * @param cache Struct holding the parameter cache
+ * @param coeffs Finalized SVF parameters in Q0.15/Q3.12 format
+ */
+static inline void calcCoeffsCached(
+                                    const int16_t note,
+                                    const _Q16 resonance,
+                                    ParamCache * const cache,
+                                    _Q15 * coeffs)
+{
+    const uint16_t inputs[] = {note, resonance};
+    if (updateParamCache(cache, inputs, 2))
+    {
+        calcCoeffs(
+                   note,
+                   resonance,
+                   coeffs);
+    }
+}
+
 /**
  * @brief In-place filtering of one block of samples with SVF lowpass output
  * 
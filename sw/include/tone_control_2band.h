@@ -31,10 +31,12 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 /**
  * In-place calculation of 2-band stereo tone control
  * 
+ * Filter coefficients are cached in the state and only recalculated on parameter changes
+ * @note The state must be zero-initialized before first use
  * @param params Struct holding tone control parameters
  * @param state Struct holding tone control state
  * @param xBuffer Work buffer of size >= 4 allocated in x memory
- * @param yBuffer Work buffer of size >= 6 allocated in y memory
+ * @param yBuffer Work buffer of size >= 12 allocated in y memory
  * @param bufferLeft Input/Output buffer for left stereo channel in Q0.15 format
  * @param bufferRight Input/Output buffer for right stereo channel in Q0.15 format
  */
@@ -26,6 +26,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #define	TONE_CONTROL_2BAND_TYPES_H
 
 #include "fp_lib_types.h"
+#include "param_cache_types.h"
 
 /// Tone control state
 typedef struct
@@ -41,6 +42,12 @@ typedef struct
     
     /// Treble filter state for right stereo channel
     _Q15 trebleStateRight[2];
+    
+    /// Cached treble and bass filter coefficients
+    _Q15 coeffs[12];
+    
+    /// Parameter cache for filter coefficients
+    ParamCache cache;
 } ToneControl2BandState;
 
 
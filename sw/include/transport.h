@@ -0,0 +1,117 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file transport.h
+ * @brief Implementation of transport clock for tempo-synced modulation
+ * 
+ * The transport clock is a global song position, advanced once per block from an internal tempo or from MIDI clock.
+ * Synced LFOs, chorus and delay times derive their phase or length from it by multiplication with a precomputed
+ * sync ratio, i.e. there is no division per update. As the phase is always derived from the absolute song
+ * position, synced modulation does not drift against the beat (apart from the rounding of the sync ratio itself).
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef TRANSPORT_H
+#define	TRANSPORT_H
+
+#include "transport_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Reset transport clock to song position 0, e.g. on MIDI start
+ * @param state Struct holding transport clock state
+ */
+void resetTransport(TransportState * state);
+
+/**
+ * @brief Set tempo of the internal transport clock
+ * @note This function divides, call it on tempo changes only
+ * @param state Struct holding transport clock state
+ * @param tempo Tempo in beats per minute in Q12.4 format
+ */
+void setTransportTempo(
+        TransportState * state,
+        uint16_t tempo);
+
+/**
+ * @brief Process one MIDI clock tick
+ * 
+ * The song position is snapped to the beat grid on every beat (24 ticks). The tempo is re-estimated once per beat
+ * from the number of blocks between two beats
+ * @param state Struct holding transport clock state
+ */
+void updateTransportMIDIClock(TransportState * state);
+
+/**
+ * @brief Advance transport clock by one block
+ * @param state Struct holding transport clock state
+ */
+inline static void updateTransport(TransportState * const state)
+{
+    state->phase += state->increment;
+    state->blockCount++;
+}
+
+/**
+ * @brief Calculate the phase of a synced oscillator from the transport clock
+ * 
+ * Only the fractional part of song position * ratio is needed, so a 32-bit multiplication truncated to
+ * 32 bit gives the correct phase, also when the song position wraps around
+ * @param state Struct holding transport clock state
+ * @param ratio Number of cycles per beat in Q16.16 format, see TRANSPORT_RATIO()
+ * @return Synced phase in Q0.16 format
+ */
+inline static _Q16 calcTransportPhase(
+                                      const TransportState * const state,
+                                      const uint32_t ratio)
+{
+    return (state->phase * ratio) >> 16;
+}
+
+/**
+ * @brief Calculate the position of a synced oscillator from the transport clock
+ * 
+ * Unlike calcTransportPhase(), the number of completed cycles is included, so wrap-arounds can be told apart from
+ * small backward steps of the song position (e.g. snaps to the MIDI clock beat grid)
+ * @param state Struct holding transport clock state
+ * @param ratio Number of cycles per beat in Q16.16 format, see TRANSPORT_RATIO()
+ * @return Number of cycles in Q16.16 format, i.e. cycle count (modulo 65536) in the high word and phase in the low word
+ */
+inline static uint32_t calcTransportPosition(
+                                             const TransportState * const state,
+                                             const uint32_t ratio)
+{
+    return ((uint64_t) state->phase * ratio) >> 16;
+}
+
+/**
+ * @brief Calculate a tempo-synced delay time
+ * @param state Struct holding transport clock state
+ * @param ratio Delay time in beats in Q16.16 format, see TRANSPORT_RATIO()
+ * @return Delay time in blocks, rounded down
+ */
+inline static uint16_t calcTransportDelayBlocks(
+                                                const TransportState * const state,
+                                                const uint32_t ratio)
+{
+    return ((uint64_t) state->blocksPerBeat * ratio) >> 32;
+}
+
+#endif
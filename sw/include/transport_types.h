@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file transport_types.h
+ * @brief Definition of transport clock types
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+*/
+
+#ifndef TRANSPORT_TYPES_H
+#define	TRANSPORT_TYPES_H
+
+#include <stdint.h>
+
+/// Sample rate in Hz the transport tempo is calculated for
+#define TRANSPORT_SAMPLE_RATE 48000UL
+
+/// Number of MIDI clock ticks per beat (quarter note)
+#define TRANSPORT_MIDI_CLOCKS_PER_BEAT 24
+
+/**
+ * @brief Build a transport sync ratio from a fraction at compile time
+ * 
+ * Sync ratios are given in Q16.16 format. For LFOs the ratio is the number of cycles per beat, e.g.
+ * TRANSPORT_RATIO(4, 1) for 1/16 notes or TRANSPORT_RATIO(3, 2) for 1/4 triplets. For delay times
+ * the ratio is the number of beats, e.g. TRANSPORT_RATIO(3, 4) for a dotted 1/8 note
+ */
+#define TRANSPORT_RATIO(num, den) ((uint32_t)((((uint64_t)(num)) << 16) / (den)))
+
+/// Transport clock state
+typedef struct
+{
+    /// Song position in beats in Q16.16 format, wraps around after 65536 beats
+    uint32_t phase;
+
+    /// Phase increment per block in beats in Q16.16 format
+    uint32_t increment;
+
+    /// Number of blocks per beat in Q16.16 format
+    uint32_t blocksPerBeat;
+
+    /// Number of blocks since the last beat (needed for MIDI clock tempo estimation)
+    uint16_t blockCount;
+
+    /// Index of the next MIDI clock tick within the current beat
+    uint16_t clockTick;
+
+    /// Beat counter for MIDI clock
+    uint16_t beat;
+} TransportState;
+
+#endif
@@ -102,6 +102,34 @@ inline static void calcVario1PoleStereoBlock(
     calcFilter(params->alpha, stateRight, dataRight);
 }
 
+/**
+ * @brief Filter a stereo block of samples with variable length by 1-pole IIR variable filter
+ * @note Use this function for blocks not equal to BLOCK_LEN, e.g. for signals at reduced sample rate
+ * @param shape Filter shape. Lowpass for shape < 0 and highpass for shape > 0
+ * @param stateLeft Struct holding 1-pole IIR filter struct for left stereo channel
+ * @param stateRight Struct holding 1-pole IIR filter struct for right stereo channel
+ * @param dataLeft Block of data samples to be filtered for left stereo channel in Q0.15 format
+ * @param dataRight Block of data samples to be filtered for right stereo channel in Q0.15 format
+ * @param len Number of samples to be filtered per channel (len > 0)
+ */
+inline static void calcVario1PoleStereoBlockLen(
+                                                const Vario1PoleParams * const params,
+                                                IIROnePoleState * const stateLeft,
+                                                IIROnePoleState * const stateRight,
+                                                _Q15 * const dataLeft,
+                                                _Q15 * const dataRight,
+                                                const uint16_t len)
+{
+    typedef void (*CalcFilter1PoleBlockLen)(const _Q15, IIROnePoleState * const, _Q15 *, const uint16_t);
+    static const CalcFilter1PoleBlockLen calcFilter1PoleBlockLen[2] = {
+        calcLP1PoleBlockLen,
+        calcHP1PoleBlockLen
+    };
+    const CalcFilter1PoleBlockLen calcFilter = calcFilter1PoleBlockLen[params->filterType];
+    calcFilter(params->alpha, stateLeft, dataLeft, len);
+    calcFilter(params->alpha, stateRight, dataRight, len);
+}
+
 /**
  * @brief Filter one sample by 1-pole IIR variable filter
  * @param shape Filter shape. Lowpass for shape < 0 and highpass for shape > 0
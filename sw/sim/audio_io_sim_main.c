@@ -0,0 +1,104 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file audio_io_sim_main.c
+ * @brief Host driver for the audio I/O simulation
+ * 
+ * Runs the simulated DMA with a render callback that busy-waits for a given time per block, prints the statistics
+ * and returns a non-zero exit code on late renders or dropped blocks, e.g. for use in CI:
+ * audio_io_sim [number of blocks] [render time per block in us] [sample rate in Hz]
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+// clock_gettime() is POSIX, not part of ISO C
+#define _POSIX_C_SOURCE 200112L
+
+#include "audio_io.h"
+#include "audio_io_sim.h"
+#include "audio_io_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/// Default simulated sample rate in Hz
+#define AUDIO_IO_SIM_SAMPLE_RATE 48000
+
+/// Simulated DMA memory
+static _Q15 rxMemory[NOF_AUDIO_IO_BUFFERS * AUDIO_IO_BUFFER_LEN];
+static _Q15 txMemory[NOF_AUDIO_IO_BUFFERS * AUDIO_IO_BUFFER_LEN];
+
+/**
+ * @brief Render callback simulating a given processing load
+ * @param context Pointer to the render time in ns
+ * @param dataL Audio data for left stereo channel
+ * @param dataR Audio data for right stereo channel
+ */
+static void renderLoad(
+        void * const context,
+        _Q15 * const dataL,
+        _Q15 * const dataR)
+{
+    const uint64_t renderTime = *(const uint64_t *) context;
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t end = (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec + renderTime;
+
+    // Pass input through while waiting
+    (void) dataL;
+    (void) dataR;
+    do
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec < end);
+}
+
+int main(int argc, char * argv[])
+{
+    const uint32_t nofBlocks = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000;
+    uint64_t renderTime = (argc > 2) ? strtoull(argv[2], NULL, 10) * 1000ULL : 0;
+    const uint32_t sampleRate = (argc > 3) ? strtoul(argv[3], NULL, 10) : AUDIO_IO_SIM_SAMPLE_RATE;
+
+    AudioIOState io;
+    AudioIOSimStats stats;
+
+    initAudioIO(
+            &io,
+            rxMemory,
+            txMemory,
+            renderLoad,
+            &renderTime);
+
+    runAudioIOSimulation(
+            &io,
+            sampleRate,
+            nofBlocks,
+            &stats);
+
+    printf("blocks: %lu\n", (unsigned long) stats.nofBlocks);
+    printf("late renders: %lu\n", (unsigned long) stats.nofLateRenders);
+    printf("dropped blocks: %lu\n", (unsigned long) stats.nofDroppedBlocks);
+    printf("block period: %lu ns\n", (unsigned long) stats.blockPeriod);
+    printf("max. render time: %lu ns\n", (unsigned long) stats.maxRenderTime);
+    printf("nominal latency: %lu ns\n", (unsigned long) stats.latency);
+
+    return (stats.nofLateRenders || stats.nofDroppedBlocks) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
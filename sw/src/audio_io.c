@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file audio_io.c
+ * @brief Implementation of double-buffered audio I/O
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "audio_io.h"
+#include "audio_io_types.h"
+#include "fp_lib_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Initialize audio I/O state
+ * @param io Struct holding audio I/O state
+ * @param rxMemory Receive DMA memory of NOF_AUDIO_IO_BUFFERS * AUDIO_IO_BUFFER_LEN words
+ * @param txMemory Transmit DMA memory of NOF_AUDIO_IO_BUFFERS * AUDIO_IO_BUFFER_LEN words, will be cleared
+ * @param render Render callback
+ * @param context Context pointer passed to the render callback
+ */
+void initAudioIO(
+        AudioIOState * const io,
+        _Q15 * const rxMemory,
+        _Q15 * const txMemory,
+        const AudioRenderCallback render,
+        void * const context)
+{
+    uint16_t i;
+    for (i = 0; i < NOF_AUDIO_IO_BUFFERS; ++i)
+    {
+        io->rxBuffer[i] = rxMemory + i * AUDIO_IO_BUFFER_LEN;
+        io->txBuffer[i] = txMemory + i * AUDIO_IO_BUFFER_LEN;
+    }
+
+    for (i = 0; i < NOF_AUDIO_IO_BUFFERS * AUDIO_IO_BUFFER_LEN; ++i)
+    {
+        txMemory[i] = 0;
+    }
+
+    io->render = render;
+    io->context = context;
+    io->completed = 0;
+    io->rendered = 0;
+    io->nofLateRenders = 0;
+    io->nofDroppedBlocks = 0;
+}
+
+/**
+ * @brief Render the last completed block
+ * 
+ * Blocks which completed while a render was still outstanding are dropped (counted in nofDroppedBlocks)
+ * @param io Struct holding audio I/O state
+ * @return true if a block has been rendered, false if no block was pending
+ */
+bool processAudioIO(AudioIOState * const io)
+{
+    const uint16_t completed = io->completed;
+    uint16_t pending = completed - io->rendered;
+
+    if (pending == 0)
+    {
+        return false;
+    }
+
+    // Only the last completed block can still be rendered in time
+    io->nofDroppedBlocks += pending - 1;
+
+    // Block n has been transferred from/to buffer n % NOF_AUDIO_IO_BUFFERS
+    const uint16_t index = (completed - 1) % NOF_AUDIO_IO_BUFFERS;
+    const _Q15 * rx = io->rxBuffer[index];
+    _Q15 * tx = io->txBuffer[index];
+
+    uint16_t i;
+    for (i = 0; i < BLOCK_LEN; ++i)
+    {
+        io->dataL[i] = *rx++;
+        io->dataR[i] = *rx++;
+    }
+
+    io->render(
+            io->context,
+            io->dataL,
+            io->dataR);
+
+    for (i = 0; i < BLOCK_LEN; ++i)
+    {
+        *tx++ = io->dataL[i];
+        *tx++ = io->dataR[i];
+    }
+
+    io->rendered = completed;
+
+    // The DMA has started to transfer the buffer if another block completed meanwhile
+    if (io->completed != completed)
+    {
+        ++io->nofLateRenders;
+    }
+
+    return true;
+}
@@ -0,0 +1,114 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file audio_io_sim.c
+ * @brief Implementation of host simulation of double-buffered audio I/O
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+// clock_gettime() is POSIX, not part of ISO C
+#define _POSIX_C_SOURCE 200112L
+
+#include "audio_io_sim.h"
+#include "audio_io.h"
+#include "audio_io_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Get time of monotonic clock
+ * @return Time in ns
+ */
+static uint64_t getAudioIOSimTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * @brief Run audio I/O simulation
+ * 
+ * The sample clock is simulated, i.e. the simulation does not sleep and is not affected by host scheduling
+ * between renders. Only the render time is measured with the host clock and advances the simulated time.
+ * The simulation is single-threaded, so the DMA interrupt cannot preempt a render. Late renders are therefore
+ * detected by comparing the render end with the completion time of the next block, which is when the DMA starts
+ * to transfer the rendered buffer. Blocks completing during a late render are delivered at once afterwards, so
+ * processAudioIO() drops them as it would on the target
+ * @param io Struct holding audio I/O state as initialized by initAudioIO()
+ * @param sampleRate Simulated sample rate in Hz
+ * @param nofBlocks Number of blocks to be simulated
+ * @param stats Simulation statistics
+ */
+void runAudioIOSimulation(
+        AudioIOState * const io,
+        const uint32_t sampleRate,
+        const uint32_t nofBlocks,
+        AudioIOSimStats * const stats)
+{
+    const uint64_t period = (uint64_t) BLOCK_LEN * 1000000000ULL / sampleRate;
+    const uint16_t droppedBlocks = io->nofDroppedBlocks;
+
+    stats->nofBlocks = nofBlocks;
+    stats->nofLateRenders = 0;
+    stats->blockPeriod = period;
+    stats->maxRenderTime = 0;
+    stats->latency = NOF_AUDIO_IO_BUFFERS * period;
+
+    // Simulated time in ns
+    uint64_t now = 0;
+    uint32_t block = 0;
+    while (block < nofBlocks)
+    {
+        // Idle until completion of the next block
+        const uint64_t due = (block + 1) * period;
+        if (now < due)
+        {
+            now = due;
+        }
+
+        // Simulated DMA interrupt for every block completed until now
+        while ((block < nofBlocks) && ((block + 1) * period <= now))
+        {
+            handleAudioIOInterrupt(io);
+            ++block;
+        }
+
+        // Render time is measured with the host clock
+        const uint64_t renderStart = getAudioIOSimTime();
+        processAudioIO(io);
+        const uint64_t renderTime = getAudioIOSimTime() - renderStart;
+
+        if (renderTime > stats->maxRenderTime)
+        {
+            stats->maxRenderTime = renderTime;
+        }
+
+        // The DMA starts to transfer the rendered buffer when the following block completes
+        now += renderTime;
+        if (now > (block + 1) * period)
+        {
+            ++stats->nofLateRenders;
+        }
+    }
+
+    stats->nofDroppedBlocks = (uint16_t) (io->nofDroppedBlocks - droppedBlocks);
+}
@@ -0,0 +1,103 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file bitcrusher.c
+ * @brief Implementation of bitcrusher effect
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "bitcrusher.h"
+#include "bitcrusher_types.h"
+#include "fp_lib_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+
+/**
+ * @brief Add bitcrusher effect to stereo signal
+ *
+ * The input signal is sampled and held whenever the 32-bit bitcrusher clock overflows. Each new sample is quantized by
+ * masking out the least significant bits. The result is mixed with the dry signal
+ * @note The working length of this function is BLOCK_LEN
+ * @note The processing cost is 15 cycles per stereo sample (max.) plus ~25 cycles per block
+ * @param params Struct holding bitcrusher parameters
+ * @param state Struct holding bitcrusher state
+ * @param dataL Audio data for left stereo channel
+ * @param dataR Audio data for right stereo channel
+ */
+void addBitcrusher(
+        const BitcrusherParams * const params,
+        BitcrusherState * const state,
+        _Q15 * dataL,
+        _Q15 * dataR)
+{
+    // Clock increment in Q0.32 format, both words are set to the Q0.16 sample rate, i.e. increment = sampleRate * 65537.
+    // This maps 0xFFFF to 0xFFFFFFFF, so sample rate 1 gives a clock overflow every sample
+    const uint16_t inc = params->sampleRate;
+
+    // Quantization removes up to 15 least significant bits
+    const uint16_t mask = 0xFFFF << (params->quantization >> 12);
+
+    // Cache state for use with inline assembly
+    uint16_t clockLow = state->clock;
+    uint16_t clockHigh = state->clock >> 16;
+    _Q15 lastL = state->lastL;
+    _Q15 lastR = state->lastR;
+    _Q15 dry;
+
+    // Loop all samples
+    __asm__ volatile(
+            "\
+    ;Start processing loop                                                      ;\n \
+        do #%[Len]-1, Bitcrusher_%=                                             ;\n \
+                                                                                ;\n \
+    ;Update bitcrusher clock, sample and hold on clock overflow                 ;\n \
+        add     %[inc], %[clockLow], %[clockLow]                                ;clock += increment (low word) \n \
+        addc    %[inc], %[clockHigh], %[clockHigh]                              ;clock += increment (high word) \n \
+        bra     nc, BitcrusherHold_%=                                           ;Hold last samples if there is no clock overflow \n \
+        and     %[mask], [%[xL]], %[lastL]                                      ;lastL = quantized left sample \n \
+        and     %[mask], [%[xR]], %[lastR]                                      ;lastR = quantized right sample \n \
+                                                                                ;\n \
+    BitcrusherHold_%=:                                                          ;\n \
+    ;Mix left channel: x = (1 - mix) * x + mix * crushed                        ;\n \
+        mov     [%[xL]], %[dry]                                                 ;dry = left sample \n \
+        lac     %[dry], #0, A                                                   ;AccA = dry \n \
+        msc     %[dry] * %[mix], A                                              ;AccA -= dry * mix \n \
+        mac     %[mix] * %[lastL], A                                            ;AccA += crushed * mix \n \
+        sac.r   A, #0, [%[xL]++]                                                ;Store AccA in left channel, increment pointer \n \
+                                                                                ;\n \
+    ;Mix right channel: x = (1 - mix) * x + mix * crushed                       ;\n \
+        mov     [%[xR]], %[dry]                                                 ;dry = right sample \n \
+        lac     %[dry], #0, A                                                   ;AccA = dry \n \
+        msc     %[dry] * %[mix], A                                              ;AccA -= dry * mix \n \
+        mac     %[mix] * %[lastR], A                                            ;AccA += crushed * mix \n \
+                                                                                ;\n \
+    Bitcrusher_%=:                                                              ;\n \
+        sac.r   A, #0, [%[xR]++]                                                ;Store AccA in right channel, increment pointer \n \
+                                                                                ;\n \
+        ; 2 + 15N cycles total (max.)"
+            : [xL]"+r"(dataL), [xR]"+r"(dataR), [clockLow]"+r"(clockLow), [clockHigh]"+r"(clockHigh), [lastL]"+z"(lastL), [lastR]"+z"(lastR), [dry]"=&z"(dry) /*out*/
+            : [Len]"i"(BLOCK_LEN), [inc]"r"(inc), [mask]"r"(mask), [mix]"z"(params->mix) /*in*/
+            : /*clobbered*/
+            );
+
+    // Write back state
+    state->clock = ((uint32_t)clockHigh << 16) | clockLow;
+    state->lastL = lastL;
+    state->lastR = lastR;
+}
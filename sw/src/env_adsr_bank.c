@@ -0,0 +1,109 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file env_adsr_bank.c
+ * @brief Implementation of ADSR envelope bank
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "env_adsr_bank.h"
+#include "env_adsr_bank_types.h"
+#include "env_adsr.h"
+#include "fp_lib_types.h"
+#include "fp_lib_mul.h"
+#include <stdint.h>
+
+/**
+ * @brief Update all envelopes of an ADSR envelope bank
+ * 
+ * All envelopes share the same envelope parameters and behave like updateEnvADSR(). Stage transitions are
+ * calculated for all envelopes at once by bitmask operations, the decay factors are looked up once per stage
+ * and each stage is processed by its own loop. Idle envelopes are skipped entirely
+ * @note A zero-initialized bank is valid, all envelopes are idle
+ * @param params Struct holding ADSR envelope parameters
+ * @param gates Flags indicating the gate is open, bit n for envelope n
+ * @param triggers Flags indicating the envelope has been (re-)triggered, bit n for envelope n
+ * @param bank Struct holding ADSR envelope bank state, the envelope values in Q0.16 format are updated in bank->value[]
+ */
+void updateEnvADSRBank(
+        const ADSRParams * const params,
+        const uint16_t gates,
+        const uint16_t triggers,
+        ADSRBank * const bank)
+{
+    // Stage transitions
+    // Note off --> Release stage, (re-)trigger while the gate is open --> Attack stage
+    const uint16_t trig = triggers & gates;
+    const uint16_t release = (bank->release | ((bank->attack | bank->decay) & ~gates)) & ~trig;
+    uint16_t attack = (bank->attack & gates) | trig;
+    uint16_t decay = bank->decay & gates & ~trig;
+    uint16_t mask;
+
+    // Release:
+    // Output = LastOutput * R
+    const _Q16 r = expDecayTable[params->release];
+    uint16_t active = release;
+    for (mask = release; mask; mask &= mask - 1)
+    {
+        const uint16_t i = __builtin_ff1r(mask) - 1;
+        // Truncating multiplication, so the value decreases by at least 1 per update and cannot stall due to rounding
+        const _Q16 value = __builtin_muluu(bank->value[i], r) >> 16;
+
+        // Envelopes which have decayed to (almost) zero become idle
+        if (value < ADSR_BANK_IDLE_THRESHOLD)
+        {
+            bank->value[i] = 0;
+            active &= ~(1u << i);
+        }
+        else
+        {
+            bank->value[i] = value;
+        }
+    }
+    bank->release = active;
+
+    // Decay:
+    // Output = S + (LastOutput - S) * D
+    const _Q16 d = expDecayTable[params->decay];
+    const _Q16 sustain = params->sustain;
+    for (mask = decay; mask; mask &= mask - 1)
+    {
+        const uint16_t i = __builtin_ff1r(mask) - 1;
+        bank->value[i] = mul_Q16_Q16(bank->value[i] - sustain, d) + sustain;
+    }
+
+    // Attack:
+    // Output = 1 - (1 - LastOutput) * A
+    const _Q16 a = expDecayTable[params->attack];
+    for (mask = attack; mask; mask &= mask - 1)
+    {
+        const uint16_t i = __builtin_ff1r(mask) - 1;
+        const _Q16 value = ~mul_Q16_Q16(~bank->value[i], a);
+        bank->value[i] = value;
+
+        // Attack has settled --> Decay
+        if (value == 0xFFFF)
+        {
+            attack &= ~(1u << i);
+            decay |= 1u << i;
+        }
+    }
+    bank->attack = attack;
+    bank->decay = decay;
+}
@@ -0,0 +1,232 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file env_mseg.c
+ * @brief Implementation of multi-segment envelope
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "env_mseg.h"
+#include "env_mseg_types.h"
+#include "env_adsr.h"
+#include "fp_lib_types.h"
+#include "fp_lib_mul.h"
+#include "ramp.h"
+#include "block_len_def.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Progress increment per update of linear and hold segments
+ * 
+ * A segment with time i lasts 65536 / linearRateTable[i] updates.
+ * Table values are calculated as min(max(round(65536 / 2^(16 * i / 255)), 1), 65535), i.e. 1 ... 65536 updates
+ */
+static const _Q16 linearRateTable[256] = {
+    65535, 62747, 60076, 57520, 55072, 52728, 50484, 48335, 46278, 44308, 42423, 40617, 38889, 37234, 35649, 34132,
+    32679, 31288, 29957, 28682, 27461, 26292, 25173, 24102, 23076, 22094, 21154, 20253, 19392, 18566, 17776, 17020,
+    16295, 15602, 14938, 14302, 13693, 13110, 12552, 12018, 11507, 11017, 10548, 10099, 9669, 9258, 8864, 8487,
+    8125, 7780, 7449, 7132, 6828, 6537, 6259, 5993, 5738, 5494, 5260, 5036, 4822, 4616, 4420, 4232,
+    4052, 3879, 3714, 3556, 3405, 3260, 3121, 2988, 2861, 2739, 2623, 2511, 2404, 2302, 2204, 2110,
+    2020, 1934, 1852, 1773, 1698, 1625, 1556, 1490, 1427, 1366, 1308, 1252, 1199, 1148, 1099, 1052,
+    1007, 965, 924, 884, 847, 811, 776, 743, 711, 681, 652, 624, 598, 572, 548, 525,
+    502, 481, 461, 441, 422, 404, 387, 371, 355, 340, 325, 311, 298, 285, 273, 262,
+    250, 240, 230, 220, 210, 202, 193, 185, 177, 169, 162, 155, 149, 142, 136, 130,
+    125, 120, 115, 110, 105, 100, 96, 92, 88, 84, 81, 77, 74, 71, 68, 65,
+    62, 60, 57, 55, 52, 50, 48, 46, 44, 42, 40, 39, 37, 35, 34, 32,
+    31, 30, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 18, 17, 16,
+    15, 15, 14, 14, 13, 12, 12, 11, 11, 10, 10, 10, 9, 9, 8, 8,
+    8, 7, 7, 7, 6, 6, 6, 6, 5, 5, 5, 5, 5, 4, 4, 4,
+    4, 4, 4, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+/**
+ * @brief Start an envelope segment from the current envelope value
+ * @param segment Segment index
+ * @param state Struct holding multi-segment envelope state
+ */
+static inline void startEnvMSEGSegment(
+        const uint16_t segment,
+        MSEGState * const state)
+{
+    state->segment = segment;
+    state->start = state->value;
+    state->progress = 0;
+}
+
+/**
+ * @brief Calculate multi-segment envelope parameters
+ * 
+ * Look up the per-update coefficient of each segment, call this function whenever a segment has changed
+ * @param params Struct holding multi-segment envelope parameters
+ */
+void calcEnvMSEGParams(MSEGParams * const params)
+{
+    for (uint16_t i = 0; i < params->nofSegments; i++)
+    {
+        const MSEGSegment * const segment = &params->segment[i];
+        params->coeff[i] = (segment->curve == MSEG_CURVE_EXP) ? expDecayTable[segment->time] : linearRateTable[segment->time];
+    }
+}
+
+/**
+ * @brief Update multi-segment envelope
+ * 
+ * Update the envelope state from envelope parameters and return the output value calculated from the updated state
+ * @note This envelope is retriggerable, a retriggered envelope starts from its current value
+ * @param params Struct holding multi-segment envelope parameters
+ * @param gate Flag indicating the gate is open
+ * @param trigger Flag indicating the envelope has been (re-)triggered
+ * @param state Struct holding multi-segment envelope state
+ * @return Envelope output value in Q0.16 format
+ */
+_Q16 updateEnvMSEG(
+        const MSEGParams * const params,
+        const bool gate,
+        const bool trigger,
+        MSEGState * const state)
+{
+    // Check for segment changes caused by gate and trigger
+    if (!gate)
+    {
+        // Note off --> Release segment
+        if (state->segment < params->releaseSegment)
+        {
+            startEnvMSEGSegment(
+                    params->releaseSegment,
+                    state);
+        }
+    }
+    else if (trigger)
+    {
+        // (Re-) Trigger the envelope --> First segment
+        startEnvMSEGSegment(
+                0,
+                state);
+    }
+
+    // Envelope has finished, hold last value
+    const uint16_t segmentIndex = state->segment;
+    if (segmentIndex >= params->nofSegments)
+    {
+        return state->value;
+    }
+
+    const MSEGSegment * const segment = &params->segment[segmentIndex];
+    const _Q16 coeff = params->coeff[segmentIndex];
+    const _Q16 level = segment->level;
+    bool finished;
+
+    // Update the envelope value
+    switch (segment->curve)
+    {
+        case MSEG_CURVE_EXP:
+        {
+            // Output = Level + (LastOutput - Level) * Coeff
+            const bool falling = state->value >= level;
+            const _Q16 lastDiff = falling ? state->value - level : level - state->value;
+            // Truncating multiplication, so the difference decreases by at least 1 per update and cannot stall
+            const _Q16 diff = __builtin_muluu(lastDiff, coeff) >> 16;
+            state->value = falling ? level + diff : level - diff;
+
+            // The segment has settled when the difference is small
+            finished = diff < MSEG_SETTLE_THRESHOLD;
+            break;
+        }
+
+        case MSEG_CURVE_HOLD:
+        {
+            // Output = Level for the segment time
+            const uint32_t progress = (uint32_t) state->progress + coeff;
+            finished = progress > 0xFFFF;
+            state->progress = finished ? 0xFFFF : progress;
+            state->value = level;
+            break;
+        }
+
+        case MSEG_CURVE_LINEAR:
+        default:
+        {
+            // Output = Start + (Level - Start) * Progress
+            // Progress saturates, so a finished sustain segment stays at the level while the gate is open
+            const uint32_t progress = (uint32_t) state->progress + coeff;
+            finished = progress > 0xFFFF;
+            state->progress = finished ? 0xFFFF : progress;
+            if (level >= state->start)
+            {
+                state->value = state->start + mul_Q16_Q16(level - state->start, state->progress);
+            }
+            else
+            {
+                state->value = state->start - mul_Q16_Q16(state->start - level, state->progress);
+            }
+            break;
+        }
+    }
+
+    if (finished)
+    {
+        state->value = level;
+
+        // Hold the sustain level while the gate is open, otherwise continue with next segment
+        if (!gate || segmentIndex != params->sustainSegment)
+        {
+            startEnvMSEGSegment(
+                    segmentIndex + 1,
+                    state);
+        }
+    }
+
+    return state->value;
+}
+
+/**
+ * @brief Update multi-segment envelope for one block of samples
+ * 
+ * Update the envelope state once like updateEnvMSEG() and write a linear ramp from the previous to the updated value
+ * @param params Struct holding multi-segment envelope parameters
+ * @param gate Flag indicating the gate is open
+ * @param trigger Flag indicating the envelope has been (re-)triggered
+ * @param state Struct holding multi-segment envelope state
+ * @param data Buffer of BLOCK_LEN samples to be filled with envelope values in Q0.16 format
+ */
+void updateEnvMSEGBlock(
+        const MSEGParams * const params,
+        const bool gate,
+        const bool trigger,
+        MSEGState * const state,
+        _Q16 * data)
+{
+    const _Q16 lastValue = state->value;
+    const _Q16 value = updateEnvMSEG(
+            params,
+            gate,
+            trigger,
+            state);
+
+    // Spread the change of the envelope value evenly over the block (halved change in Q16.16 format)
+    calcRampBlock(
+            (uint32_t) lastValue << 16,
+            calcRampIncrement(((int32_t) value - (int32_t) lastValue) * 32768),
+            data);
+
+    // Last sample equals the updated envelope value
+    data[BLOCK_LEN - 1] = value;
+}
@@ -1,93 +1,514 @@
-#include "FormantFilter.h"
-#include "SVF_2Pole.h"
-#include <stdint.h>
-#include "fp_lib.h"
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file formant_filter.c
+ * @brief Implementation of formant filter
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "formant_filter.h"
+#include "formant_filter_types.h"
+#include "fp_lib_types.h"
+#include "fp_lib_typeconv.h"
+#include "fp_lib_mul.h"
 #include "block_len_def.h"
+#include <stdint.h>
+
+/// Number of SVF coefficients per filter stage (a[0], a[1], a[2] = g)
+#define NOF_STAGE_COEFFS 3
+
+/// Number of SVF coefficients per filter stage in parallel mode (a[0], a[1], a[1] * gain, 0.5, 2 * g)
+#define NOF_PARALLEL_STAGE_COEFFS 5
 
-#define NOF_VOWELS 5
+/**
+ * @brief Lookup table for SVF coefficients of all vowels
+ *
+ * Coefficients a[0], a[1] and a[2] of each filter stage as calculated by calcCoeffs() in svf_2pole.h
+ * for the following formant frequencies (MIDI note scale given in half-cents) and resonances (Q0.15 format):\n
+ * Frequency: {15647, 17236, 19944, 21248}, Resonance: {30798, 31248, 31694, 31684}\n
+ * Frequency: {14021, 19096, 20065, 20854}, Resonance: {29609, 31880, 31731, 31554}\n
+ * Frequency: {12321, 19498, 20656, 21248}, Resonance: {27566, 31978, 31894, 31684}\n
+ * Frequency: {14014, 15787, 20025, 20757}, Resonance: {29603, 30455, 31719, 31519}\n
+ * Frequency: {12610, 17328, 19772, 20886}, Resonance: {27992, 31288, 31639, 31565}
+ */
+static const _Q15 vowelCoeffTable[NOF_VOWELS][NOF_FORMANT_FILTER_STAGES * NOF_STAGE_COEFFS] = {
+    {32490, 1586, 200, 32333, 2510, 318, 31484, 5397, 702, 30317, 7662, 1035},
+    {32537, 993, 125, 31956, 4268, 547, 31417, 5585, 728, 30705, 6891, 919},
+    {32553, 604, 76, 31812, 4785, 616, 31018, 6567, 867, 30317, 7662, 1035},
+    {32537, 993, 125, 32443, 1655, 209, 31439, 5520, 719, 30783, 6712, 893},
+    {32553, 659, 83, 32318, 2580, 327, 31565, 5141, 667, 30677, 6952, 928}
+};
 
-static inline int16_t CalcLinearInterpolation(
-const int16_t y1,
-const int16_t y2,
-const int16_t x)
+/**
+ * @brief Lookup table for formant gains of all vowels (parallel mode)
+ *
+ * The bandpass peak gain 1/k of each filter stage is normalized and weighted with formant levels {0.4, 0.3, 0.2, 0.1}
+ */
+static const _Q15 vowelGainTable[NOF_VOWELS][NOF_FORMANT_FILTER_STAGES] = {
+    {1574, 910, 429, 216},
+    {2525, 530, 414, 242},
+    {4160, 473, 349, 216},
+    {2531, 1387, 419, 250},
+    {3818, 886, 451, 240}
+};
+
+/**
+ * @brief Linear interpolation between two values
+ * @param y1 First value
+ * @param y2 Second value
+ * @param x Interpolation factor in Q0.15 format (0 = y1 ... 1 = y2)
+ * @return Interpolated value
+ */
+static inline _Q15 calcLinearInterpolation(
+                                           const _Q15 y1,
+                                           const _Q15 y2,
+                                           const _Q15 x)
 {
-        int16_t y = 0;
-        __asm__ volatile(
+    _Q15 y = 0;
+    __asm__ volatile(
             "\
-        lac     %[Y1], #0, A                                                       ;AccA = X1[k] \n \
-        msc     %[Y1] * %[X], A                                                  ;AccA -= X1[k] * Mix => AccA = X1[k] * (1-Mix) \n \
-        mac     %[Y2] * %[X], A                                                  ;AccA += X2[k] * Mix => AccA = X1[k] * (1-Mix) + X2[k] * Mix \n \
-        sac.r   A, #0, %[Y]                                                ;X2[k] = AccB \n \
+        lac     %[Y1], #0, A                                                    ;AccA = y1 \n \
+        msc     %[Y1] * %[X], A                                                 ;AccA -= y1 * x => AccA = y1 * (1 - x) \n \
+        mac     %[Y2] * %[X], A                                                 ;AccA += y2 * x => AccA = y1 * (1 - x) + y2 * x \n \
+        sac.r   A, #0, %[Y]                                                     ;y = AccA \n \
                                                                                 ;\n \
         ; 4 cycles total"
-            : [Y]"+r"(y)  /*out*/
+            : [Y]"+r"(y) /*out*/
             : [Y1]"z"(y1), [Y2]"z"(y2), [X]"z"(x) /*in*/
             : /*clobbered*/
             );
-            
-            return y;
+
+    return y;
 }
 
-//
-static inline uint16_t GetFreq(
-        const uint16_t uiStage,
-        const _Q16 qShape)
+/**
+ * @brief Calculation of SVF coefficients of all filter stages for given vowel
+ * @param vowel Vowel selection in Q0.16 format
+ * @param coeffs Interpolated SVF coefficients of all filter stages
+ */
+static inline void calcVowelCoeffs(
+                                   const _Q16 vowel,
+                                   _Q15 * const coeffs)
 {
-    static const uint16_t auiFreq[NOF_VOWELS][NOF_FORMANT_FILTER_STAGES] = {
-{15647, 17236, 19944, 21248},
-{14021, 19096, 20065, 20854},
-{12321, 19498, 20656, 21248},
-{14014, 15787, 20025, 20757},
-{12610, 17328, 19772, 20886}
-    };
-    
-    const uint16_t uiVowel = qShape >> 14;
-    const int16_t iShape = (qShape << 2) >> 1;
-    return CalcLinearInterpolation(auiFreq[uiVowel][uiStage], auiFreq[uiVowel+1][uiStage], iShape) << 1;
+    const uint16_t vowelInt = vowel >> (16 - NOF_VOWELS_POW2);
+    const _Q15 vowelFract = convert_Q16_Q15(vowel << NOF_VOWELS_POW2);
+    const _Q15 * coeffs1 = vowelCoeffTable[vowelInt];
+    const _Q15 * coeffs2 = vowelCoeffTable[vowelInt + 1];
+
+    uint16_t cnt;
+    for (cnt = 0; cnt < NOF_FORMANT_FILTER_STAGES * NOF_STAGE_COEFFS; ++cnt)
+    {
+        coeffs[cnt] = calcLinearInterpolation(
+                coeffs1[cnt],
+                coeffs2[cnt],
+                vowelFract);
+    }
 }
 
-//
-static inline _Q16 GetQ(
-        const uint16_t uiStage,
-        const _Q16 qShape)
+/**
+ * @brief Calculation of SVF coefficients and formant gains of all filter stages for given vowel (parallel mode)
+ * @param vowel Vowel selection in Q0.16 format
+ * @param coeffs Interpolated SVF coefficients of all filter stages
+ */
+static inline void calcParallelVowelCoeffs(
+                                           const _Q16 vowel,
+                                           _Q15 * coeffs)
 {
-    static const _Q16 aqQ[NOF_VOWELS][NOF_FORMANT_FILTER_STAGES] = {
-{30798, 31248, 31694, 31684},
-{29609, 31880, 31731, 31554},
-{27566, 31978, 31894, 31684},
-{29603, 30455, 31719, 31519},
-{27992, 31288, 31639, 31565}
-    };
-    
-    const uint16_t uiVowel = qShape >> 14;
-    const int16_t iShape = (qShape << 2) >> 1;
-    return CalcLinearInterpolation(aqQ[uiVowel][uiStage], aqQ[uiVowel+1][uiStage], iShape) << 1;
+    const uint16_t vowelInt = vowel >> (16 - NOF_VOWELS_POW2);
+    const _Q15 vowelFract = convert_Q16_Q15(vowel << NOF_VOWELS_POW2);
+    const _Q15 * coeffs1 = vowelCoeffTable[vowelInt];
+    const _Q15 * coeffs2 = vowelCoeffTable[vowelInt + 1];
+    const _Q15 * gains1 = vowelGainTable[vowelInt];
+    const _Q15 * gains2 = vowelGainTable[vowelInt + 1];
+
+    uint16_t stage;
+    for (stage = 0; stage < NOF_FORMANT_FILTER_STAGES; ++stage)
+    {
+        const _Q15 a1 = calcLinearInterpolation(coeffs1[1], coeffs2[1], vowelFract);
+        const _Q15 g = calcLinearInterpolation(coeffs1[2], coeffs2[2], vowelFract);
+        const _Q15 gain = calcLinearInterpolation(gains1[stage], gains2[stage], vowelFract);
+
+        coeffs[0] = calcLinearInterpolation(coeffs1[0], coeffs2[0], vowelFract);
+        coeffs[1] = a1;
+        coeffs[2] = mul_Q15_Q15(a1, gain);
+        coeffs[3] = 16384; // 0.5
+        coeffs[4] = g << 1;
+
+        coeffs1 += NOF_STAGE_COEFFS;
+        coeffs2 += NOF_STAGE_COEFFS;
+        coeffs += NOF_PARALLEL_STAGE_COEFFS;
+    }
 }
 
-//
-void CalcFormantFilterInplace(
-        const unsigned int uiFreq,
-        const _Q16 qShape,
-        SFORMANT_FILTER_STATE * psState,
-        _Q15 * pqData)
+/**
+ * @brief In-place filtering of one block of samples with cascaded SVF lowpass filters
+ *
+ * Calculation of SVF output according to the notation as found in:\n
+ * https://cytomic.com/files/dsp/SvfLinearTrapOptimised2.pdf
+ *
+ * All filter stages are processed per sample within one loop, the output of each stage is passed to the next stage in w6.
+ * Filter states are addressed relative to the prefetch pointer, so no extra pointer update is needed between the stages
+ * @note This function is written for NOF_FORMANT_FILTER_STAGES = 4
+ * @param coeffs SVF coefficients a[0], a[1], a[2] of all filter stages allocated in y memory
+ * @param filterState SVF states s[0], s[1] of all filter stages allocated in x memory
+ * @param data  Buffer of BLOCK_LEN samples to be filtered allocated in x memory
+ */
+static inline void calcLP2PoleCascadeBlockInplace(
+                                                  const _Q15 * coeffs,
+                                                  _Q15 * filterState,
+                                                  _Q15 * data)
 {
-    uint16_t uiCFilterStage;
-    for (uiCFilterStage = 0; uiCFilterStage < NOF_FORMANT_FILTER_STAGES; ++uiCFilterStage)
-    {
+    // Offset of current filter stage state relative to prefetch pointer (in bytes)
+    const int16_t offset = -4;
 
-        const unsigned int uiCutOff = uiFreq + GetFreq(
-                uiCFilterStage,
-                qShape);
+    // Offset of last filter stage state s[1] relative to prefetch pointer after rewind (in bytes)
+    const int16_t offsetLast = 2 * (2 * NOF_FORMANT_FILTER_STAGES - 2);
+
+    // Loop all samples
+    __asm__ volatile(
+            "\
+        movsac  A, [%[s]]+=2, w4, [%[a]]+=2, w5                                 ;Prefetch s[0] and a[0] of stage 1 \n \
+                                                                                ;\n \
+    ;Start processing loop                                                      ;\n \
+        do #%[Len]-1, CalcLP2PoleCascade_%=                                     ;\n \
+                                                                                ;\n \
+    ;Stage 1: v1 = a[0] * s[0] - a[1] * s[1] + a[1] * x                         ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w4 * w5, A, [%[x]], w6                                          ;AccA -= s[1] * a[1], prefetch x \n \
+        mac     w5 * w6, A, [%[a]]+=2, w5                                       ;AccA += x * a[1], prefetch a[2] \n \
+        sac.r   A, #0, w4                                                       ;Store v1 in w4 \n \
+                                                                                ;\n \
+    ;Stage 1: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                    ;\n \
+        lac     [%[s] + %[off]], #1, B                                          ;AccB = 0.5 * s[0] \n \
+        sub     A                                                               ;AccA = v1 - 0.5 * s[0] \n \
+        sac.r   A, #-1, [%[s] + %[off]]                                         ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;Stage 1: v2 = s[1] + g * v1                                                ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * a[2], prefetch s[0] and a[0] of stage 2 \n \
+        add     [%[s] + %[off]], #3, A                                          ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+        sac.r   A, #-3, w6                                                      ;Store v2 in w6 as input of stage 2 (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 1: s[1] = 2 * v2 - s[1] = 2 * ( v2 - 0.5 * s[1] )                    ;\n \
+        lac     [%[s] + %[off]], #4, B                                          ;AccB = 0.5 * s[1] (Q0.15 --> Q3.12) \n \
+        sub     A                                                               ;AccA = v2 - 0.5 * s[1] \n \
+        sac.r   A, #-4, [%[s] + %[off]]                                         ;Store AccA * 2 in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 2: v1 = a[0] * s[0] - a[1] * s[1] + a[1] * x                         ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w4 * w5, A                                                      ;AccA -= s[1] * a[1] \n \
+        mac     w5 * w6, A, [%[a]]+=2, w5                                       ;AccA += x * a[1], prefetch a[2] \n \
+        sac.r   A, #0, w4                                                       ;Store v1 in w4 \n \
+                                                                                ;\n \
+    ;Stage 2: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                    ;\n \
+        lac     [%[s] + %[off]], #1, B                                          ;AccB = 0.5 * s[0] \n \
+        sub     A                                                               ;AccA = v1 - 0.5 * s[0] \n \
+        sac.r   A, #-1, [%[s] + %[off]]                                         ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;Stage 2: v2 = s[1] + g * v1                                                ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * a[2], prefetch s[0] and a[0] of stage 3 \n \
+        add     [%[s] + %[off]], #3, A                                          ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+        sac.r   A, #-3, w6                                                      ;Store v2 in w6 as input of stage 3 (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 2: s[1] = 2 * v2 - s[1] = 2 * ( v2 - 0.5 * s[1] )                    ;\n \
+        lac     [%[s] + %[off]], #4, B                                          ;AccB = 0.5 * s[1] (Q0.15 --> Q3.12) \n \
+        sub     A                                                               ;AccA = v2 - 0.5 * s[1] \n \
+        sac.r   A, #-4, [%[s] + %[off]]                                         ;Store AccA * 2 in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 3: v1 = a[0] * s[0] - a[1] * s[1] + a[1] * x                         ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w4 * w5, A                                                      ;AccA -= s[1] * a[1] \n \
+        mac     w5 * w6, A, [%[a]]+=2, w5                                       ;AccA += x * a[1], prefetch a[2] \n \
+        sac.r   A, #0, w4                                                       ;Store v1 in w4 \n \
+                                                                                ;\n \
+    ;Stage 3: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                    ;\n \
+        lac     [%[s] + %[off]], #1, B                                          ;AccB = 0.5 * s[0] \n \
+        sub     A                                                               ;AccA = v1 - 0.5 * s[0] \n \
+        sac.r   A, #-1, [%[s] + %[off]]                                         ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;Stage 3: v2 = s[1] + g * v1                                                ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * a[2], prefetch s[0] and a[0] of stage 4 \n \
+        add     [%[s] + %[off]], #3, A                                          ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+        sac.r   A, #-3, w6                                                      ;Store v2 in w6 as input of stage 4 (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 3: s[1] = 2 * v2 - s[1] = 2 * ( v2 - 0.5 * s[1] )                    ;\n \
+        lac     [%[s] + %[off]], #4, B                                          ;AccB = 0.5 * s[1] (Q0.15 --> Q3.12) \n \
+        sub     A                                                               ;AccA = v2 - 0.5 * s[1] \n \
+        sac.r   A, #-4, [%[s] + %[off]]                                         ;Store AccA * 2 in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 4: v1 = a[0] * s[0] - a[1] * s[1] + a[1] * x                         ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w4 * w5, A                                                      ;AccA -= s[1] * a[1] \n \
+        mac     w5 * w6, A, [%[a]]+=2, w5                                       ;AccA += x * a[1], prefetch a[2] \n \
+        sac.r   A, #0, w4                                                       ;Store v1 in w4 \n \
+                                                                                ;\n \
+    ;Stage 4: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                    ;\n \
+    ;Pointers are rewound early to avoid address register stalls                ;\n \
+        sub     #4*%[Stages], %[s]                                              ;Rewind state pointer to s[0] of stage 1 (s[0] of stage 4 at offLast) \n \
+        sub     #6*%[Stages], %[a]                                              ;Rewind coefficient pointer to a[0] of stage 1 \n \
+        lac     [%[s] + %[offLast]], #1, B                                      ;AccB = 0.5 * s[0] \n \
+        sub     A                                                               ;AccA = v1 - 0.5 * s[0] \n \
+        sac.r   A, #-1, [%[s] + %[offLast]]                                     ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;Stage 4: v2 = s[1] + g * v1                                                ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * a[2], prefetch s[0] and a[0] of stage 1 for next do-loop iteration \n \
+        add     [%[s] + %[offLast]], #3, A                                      ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+        sac.r   A, #-3, [%[x]++]                                                ;Store v2 in x (Q3.28 --> Q0.15), increment x pointer \n \
+                                                                                ;\n \
+    ;Stage 4: s[1] = 2 * v2 - s[1] = 2 * ( v2 - 0.5 * s[1] )                    ;\n \
+        lac     [%[s] + %[offLast]], #4, B                                      ;AccB = 0.5 * s[1] (Q0.15 --> Q3.12) \n \
+        sub     A                                                               ;AccA = v2 - 0.5 * s[1] \n \
+                                                                                ;\n \
+    CalcLP2PoleCascade_%=:                                                      ;\n \
+        sac.r   A, #-4, [%[s] + %[offLast]]                                     ;Store AccA * 2 in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+        ; 3 + 54N cycles total"
+            : [x]"+x"(data), [s]"+x"(filterState), [a]"+y"(coeffs) /*out*/
+            : [Len]"i"(BLOCK_LEN), [Stages]"i"(NOF_FORMANT_FILTER_STAGES), [off]"r"(offset), [offLast]"r"(offsetLast) /*in*/
+            : "w4", "w5", "w6" /*clobbered*/
+            );
+}
 
-        const _Q16 qQ = GetQ(
-                uiCFilterStage,
-                qShape);
+/**
+ * @brief In-place filtering of samples with parallel SVF bandpass filters
+ *
+ * Calculation of SVF output according to the notation as found in:\n
+ * https://cytomic.com/files/dsp/SvfLinearTrapOptimised2.pdf
+ *
+ * All filter stages are fed from the same input sample, which is fetched once per sample. The formant gain is merged
+ * into the input coefficient, i.e. v1 = a[0] * s[0] - a[1] * s[1] + gain * a[1] * x. The bandpass outputs v1 are summed in AccB.
+ * The state update s[1] = 2 * v2 - s[1] is simplified to s[1] = s[1] + 2 * g * v1
+ * @note This function is written for NOF_FORMANT_FILTER_STAGES = 4
+ * @param coeffs SVF coefficients a[0], a[1], gain * a[1], 0.5, 2 * g of all filter stages allocated in y memory
+ * @param filterState SVF states s[0], s[1] of all filter stages allocated in x memory
+ * @param data Buffer of samples to be filtered allocated in x memory
+ * @param len Number of samples to be filtered
+ */
+static inline void calcBP2PoleParallelInplace(
+                                              const _Q15 * coeffs,
+                                              _Q15 * filterState,
+                                              _Q15 * data,
+                                              const uint16_t len)
+{
+    // Offset of current filter stage state relative to prefetch pointer (in bytes)
+    const int16_t offset = -4;
 
-        CalcLP2PoleInplace(
-                uiCutOff,
-                qQ,
-                &psState->asStates[uiCFilterStage],
-                pqData);
+    // Offset of last filter stage state s[1] relative to prefetch pointer after rewind (in bytes)
+    const int16_t offsetLast = 2 * (2 * NOF_FORMANT_FILTER_STAGES - 2);
+
+    // Loop all samples
+    __asm__ volatile(
+            "\
+        clr     B                                                               ;Clear output sum \n \
+        movsac  A, [%[s]]+=2, w4, [%[a]]+=2, w5                                 ;Prefetch s[0] and a[0] of stage 1 \n \
+                                                                                ;\n \
+    ;Start processing loop                                                      ;\n \
+        do %[len], CalcBP2PoleParallel_%=                                       ;\n \
+                                                                                ;\n \
+    ;Stage 1: v1 = a[0] * s[0] - a[1] * s[1] + gain * a[1] * x                  ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w7, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w5 * w7, A, [%[x]], w6, [%[a]]+=2, w5                           ;AccA -= s[1] * a[1], prefetch x and gain * a[1] \n \
+        mac     w5 * w6, A, [%[a]]+=2, w5                                       ;AccA += x * gain * a[1], prefetch 0.5 \n \
+        sac.r   A, #0, w7                                                       ;Store v1 in w7 \n \
+        add     B                                                               ;AccB += v1 \n \
+                                                                                ;\n \
+    ;Stage 1: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                    ;\n \
+        msc     w4 * w5, A, [%[a]]+=2, w5                                       ;AccA = v1 - 0.5 * s[0], prefetch 2 * g \n \
+        sac.r   A, #-1, [%[s] + %[off]]                                         ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;Stage 1: s[1] = s[1] + 2 * g * v1                                          ;\n \
+        mpy     w5 * w7, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * 2 * g, prefetch s[0] and a[0] of stage 2 \n \
+        add     [%[s] + %[off]], #3, A                                          ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+        sac.r   A, #-3, [%[s] + %[off]]                                         ;Store AccA in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 2: v1 = a[0] * s[0] - a[1] * s[1] + gain * a[1] * x                  ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w7, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w5 * w7, A, [%[a]]+=2, w5                                       ;AccA -= s[1] * a[1], prefetch gain * a[1] \n \
+        mac     w5 * w6, A, [%[a]]+=2, w5                                       ;AccA += x * gain * a[1], prefetch 0.5 \n \
+        sac.r   A, #0, w7                                                       ;Store v1 in w7 \n \
+        add     B                                                               ;AccB += v1 \n \
+                                                                                ;\n \
+    ;Stage 2: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                    ;\n \
+        msc     w4 * w5, A, [%[a]]+=2, w5                                       ;AccA = v1 - 0.5 * s[0], prefetch 2 * g \n \
+        sac.r   A, #-1, [%[s] + %[off]]                                         ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;Stage 2: s[1] = s[1] + 2 * g * v1                                          ;\n \
+        mpy     w5 * w7, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * 2 * g, prefetch s[0] and a[0] of stage 3 \n \
+        add     [%[s] + %[off]], #3, A                                          ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+        sac.r   A, #-3, [%[s] + %[off]]                                         ;Store AccA in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 3: v1 = a[0] * s[0] - a[1] * s[1] + gain * a[1] * x                  ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w7, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w5 * w7, A, [%[a]]+=2, w5                                       ;AccA -= s[1] * a[1], prefetch gain * a[1] \n \
+        mac     w5 * w6, A, [%[a]]+=2, w5                                       ;AccA += x * gain * a[1], prefetch 0.5 \n \
+        sac.r   A, #0, w7                                                       ;Store v1 in w7 \n \
+        add     B                                                               ;AccB += v1 \n \
+                                                                                ;\n \
+    ;Stage 3: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                    ;\n \
+        msc     w4 * w5, A, [%[a]]+=2, w5                                       ;AccA = v1 - 0.5 * s[0], prefetch 2 * g \n \
+        sac.r   A, #-1, [%[s] + %[off]]                                         ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;Stage 3: s[1] = s[1] + 2 * g * v1                                          ;\n \
+        mpy     w5 * w7, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * 2 * g, prefetch s[0] and a[0] of stage 4 \n \
+        add     [%[s] + %[off]], #3, A                                          ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+        sac.r   A, #-3, [%[s] + %[off]]                                         ;Store AccA in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+    ;Stage 4: v1 = a[0] * s[0] - a[1] * s[1] + gain * a[1] * x                  ;\n \
+        mpy     w4 * w5, A, [%[s]]+=2, w7, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w5 * w7, A, [%[a]]+=2, w5                                       ;AccA -= s[1] * a[1], prefetch gain * a[1] \n \
+        mac     w5 * w6, A, [%[a]]+=2, w5                                       ;AccA += x * gain * a[1], prefetch 0.5 \n \
+        sac.r   A, #0, w7                                                       ;Store v1 in w7 \n \
+        add     B                                                               ;AccB += v1 \n \
+        sac.r   B, #0, [%[x]++]                                                 ;Store output sum in x, increment x pointer \n \
+        clr     B                                                               ;Clear output sum for next do-loop iteration \n \
+                                                                                ;\n \
+    ;Stage 4: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                    ;\n \
+    ;Pointers are rewound early to avoid address register stalls                ;\n \
+        msc     w4 * w5, A, [%[a]]+=2, w5                                       ;AccA = v1 - 0.5 * s[0], prefetch 2 * g \n \
+        sub     #4*%[Stages], %[s]                                              ;Rewind state pointer to s[0] of stage 1 (s[0] of stage 4 at offLast) \n \
+        sub     #10*%[Stages], %[a]                                             ;Rewind coefficient pointer to a[0] of stage 1 \n \
+        sac.r   A, #-1, [%[s] + %[offLast]]                                     ;Store AccA * 2 in s[0] \n \
+                                                                                ;\n \
+    ;Stage 4: s[1] = s[1] + 2 * g * v1                                          ;\n \
+        mpy     w5 * w7, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA = v1 * 2 * g, prefetch s[0] and a[0] of stage 1 for next do-loop iteration \n \
+        add     [%[s] + %[offLast]], #3, A                                      ;AccA += s[1] (Q0.15 --> Q3.12) \n \
+                                                                                ;\n \
+    CalcBP2PoleParallel_%=:                                                     ;\n \
+        sac.r   A, #-3, [%[s] + %[offLast]]                                     ;Store AccA in s[1] (Q3.28 --> Q0.15) \n \
+                                                                                ;\n \
+        ; 4 + 44N cycles total"
+            : [x]"+x"(data), [s]"+x"(filterState), [a]"+y"(coeffs) /*out*/
+            : [len]"r"(len - 1), [Stages]"i"(NOF_FORMANT_FILTER_STAGES), [off]"r"(offset), [offLast]"r"(offsetLast) /*in*/
+            : "w4", "w5", "w6", "w7" /*clobbered*/
+            );
+}
+
+/**
+ * @brief In-place calculation of cascaded formant filter
+ *
+ * NOF_FORMANT_FILTER_STAGES SVF lowpass stages tuned to the formants of the selected vowel are processed per sample
+ * within one loop. Filter coefficients are interpolated between the neighboring vowels once per block
+ * @param vowel Vowel selection in Q0.16 format (0 = first vowel ... 1 = last vowel)
+ * @param state Struct holding formant filter state
+ * @param xBuffer Work buffer of size >= 2 * NOF_FORMANT_FILTER_STAGES allocated in x memory
+ * @param yBuffer Work buffer of size >= 3 * NOF_FORMANT_FILTER_STAGES allocated in y memory
+ * @param data Buffer of BLOCK_LEN samples to be filtered allocated in x memory
+ */
+void calcFormantFilterBlockInplace(
+        const _Q16 vowel,
+        FormantFilterState * const state,
+        _Q15 * const xBuffer,
+        _Q15 * const yBuffer,
+        _Q15 * const data)
+{
+    // Filter coefficients are interpolated once per block
+    calcVowelCoeffs(
+            vowel,
+            yBuffer);
+
+    // Filter states are processed in x memory
+    uint16_t stage;
+    for (stage = 0; stage < NOF_FORMANT_FILTER_STAGES; ++stage)
+    {
+        xBuffer[2 * stage] = state->states[stage].state[0];
+        xBuffer[2 * stage + 1] = state->states[stage].state[1];
+    }
+
+    calcLP2PoleCascadeBlockInplace(
+            yBuffer,
+            xBuffer,
+            data);
+
+    for (stage = 0; stage < NOF_FORMANT_FILTER_STAGES; ++stage)
+    {
+        state->states[stage].state[0] = xBuffer[2 * stage];
+        state->states[stage].state[1] = xBuffer[2 * stage + 1];
     }
 }
 
+/**
+ * @brief In-place calculation of parallel formant filter
+ *
+ * NOF_FORMANT_FILTER_STAGES SVF bandpass filters tuned to the formants of the selected vowel are fed from the same input
+ * sample and summed with per-formant gains within one loop. Filter coefficients are ramped from the previous vowel
+ * to the selected vowel in 1 << FORMANT_FILTER_RAMP_STEPS_POW2 steps per block
+ * @note The state must be zero-initialized before first use
+ * @param vowel Vowel selection in Q0.16 format (0 = first vowel ... 1 = last vowel)
+ * @param state Struct holding formant filter state
+ * @param xBuffer Work buffer of size >= 2 * NOF_FORMANT_FILTER_STAGES allocated in x memory
+ * @param yBuffer Work buffer of size >= 5 * NOF_FORMANT_FILTER_STAGES allocated in y memory
+ * @param data Buffer of BLOCK_LEN samples to be filtered allocated in x memory
+ */
+void calcFormantFilterParallelBlockInplace(
+        const _Q16 vowel,
+        FormantFilterState * const state,
+        _Q15 * const xBuffer,
+        _Q15 * const yBuffer,
+        _Q15 * const data)
+{
+    // Filter states are processed in x memory
+    uint16_t stage;
+    for (stage = 0; stage < NOF_FORMANT_FILTER_STAGES; ++stage)
+    {
+        xBuffer[2 * stage] = state->states[stage].state[0];
+        xBuffer[2 * stage + 1] = state->states[stage].state[1];
+    }
+
+    if (vowel == state->vowel)
+    {
+        // No coefficient ramping needed
+        calcParallelVowelCoeffs(
+                vowel,
+                yBuffer);
+
+        calcBP2PoleParallelInplace(
+                yBuffer,
+                xBuffer,
+                data,
+                BLOCK_LEN);
+    }
+    else
+    {
+        // Ramp filter coefficients from previous vowel to selected vowel
+        const int32_t vowelDiff = (int32_t)vowel - (int32_t)state->vowel;
+        _Q15 * subBlock = data;
+        uint16_t step;
+        for (step = 1; step <= (1 << FORMANT_FILTER_RAMP_STEPS_POW2); ++step)
+        {
+            calcParallelVowelCoeffs(
+                    state->vowel + ((vowelDiff * step) >> FORMANT_FILTER_RAMP_STEPS_POW2),
+                    yBuffer);
+
+            calcBP2PoleParallelInplace(
+                    yBuffer,
+                    xBuffer,
+                    subBlock,
+                    BLOCK_LEN >> FORMANT_FILTER_RAMP_STEPS_POW2);
+
+            subBlock += BLOCK_LEN >> FORMANT_FILTER_RAMP_STEPS_POW2;
+        }
+
+        state->vowel = vowel;
+    }
+
+    for (stage = 0; stage < NOF_FORMANT_FILTER_STAGES; ++stage)
+    {
+        state->states[stage].state[0] = xBuffer[2 * stage];
+        state->states[stage].state[1] = xBuffer[2 * stage + 1];
+    }
+}
@@ -26,31 +26,230 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include "glide_types.h"
 #include "fp_lib_types.h"
 #include "fp_lib_mul.h"
+#include "ramp.h"
+#include "block_len_def.h"
 #include <stdint.h>
 
+/**
+ * @brief Number of updates of a constant time glide, indexed by the upper 8 bits of the glide time
+ * Table values are calculated as round(2^(12 * i / 255)), i.e. 1 ... 4096 updates
+ */
+static const uint16_t glideTimeTable[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4, 5,
+    5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 7, 7, 7, 7, 8, 8,
+    8, 8, 9, 9, 9, 9, 10, 10, 10, 11, 11, 12, 12, 12, 13, 13,
+    14, 14, 15, 15, 15, 16, 17, 17, 18, 18, 19, 19, 20, 21, 21, 22,
+    23, 24, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37,
+    39, 40, 41, 43, 44, 45, 47, 49, 50, 52, 53, 55, 57, 59, 61, 63,
+    65, 67, 69, 72, 74, 77, 79, 82, 84, 87, 90, 93, 96, 99, 103, 106,
+    110, 113, 117, 121, 125, 129, 133, 138, 142, 147, 152, 157, 162, 168, 173, 179,
+    185, 191, 197, 204, 210, 217, 225, 232, 240, 248, 256, 264, 273, 282, 292, 301,
+    311, 322, 332, 343, 355, 366, 379, 391, 404, 418, 431, 446, 461, 476, 492, 508,
+    525, 542, 560, 579, 598, 618, 638, 659, 681, 704, 727, 751, 776, 802, 828, 856,
+    884, 914, 944, 975, 1007, 1041, 1075, 1111, 1148, 1186, 1225, 1266, 1308, 1351, 1396, 1442,
+    1490, 1539, 1591, 1643, 1698, 1754, 1812, 1872, 1934, 1999, 2065, 2133, 2204, 2277, 2353, 2431,
+    2511, 2594, 2680, 2769, 2861, 2956, 3054, 3155, 3260, 3368, 3480, 3595, 3714, 3837, 3965, 4096
+};
+
+/**
+ * @brief Reciprocal of glideTimeTable[] in Q0.32 format
+ * Table values are calculated as min(round(2^32 / glideTimeTable[i]), 2^32 - 1)
+ */
+static const uint32_t glideTimeReciprocalTable[256] = {
+    4294967295, 4294967295, 4294967295, 4294967295, 4294967295, 4294967295, 4294967295, 4294967295,
+    4294967295, 4294967295, 4294967295, 4294967295, 4294967295, 2147483648, 2147483648, 2147483648,
+    2147483648, 2147483648, 2147483648, 2147483648, 2147483648, 2147483648, 2147483648, 2147483648,
+    2147483648, 2147483648, 2147483648, 2147483648, 2147483648, 1431655765, 1431655765, 1431655765,
+    1431655765, 1431655765, 1431655765, 1431655765, 1431655765, 1431655765, 1431655765, 1073741824,
+    1073741824, 1073741824, 1073741824, 1073741824, 1073741824, 1073741824, 1073741824, 858993459,
+    858993459, 858993459, 858993459, 858993459, 858993459, 715827883, 715827883, 715827883,
+    715827883, 715827883, 613566757, 613566757, 613566757, 613566757, 536870912, 536870912,
+    536870912, 536870912, 477218588, 477218588, 477218588, 477218588, 429496730, 429496730,
+    429496730, 390451572, 390451572, 357913941, 357913941, 357913941, 330382100, 330382100,
+    306783378, 306783378, 286331153, 286331153, 286331153, 268435456, 252645135, 252645135,
+    238609294, 238609294, 226050910, 226050910, 214748365, 204522252, 204522252, 195225786,
+    186737709, 178956971, 178956971, 171798692, 165191050, 159072863, 153391689, 148102321,
+    143165577, 138547332, 134217728, 130150524, 126322568, 122713351, 119304647, 116080197,
+    110127367, 107374182, 104755300, 99882960, 97612893, 95443718, 91382283, 87652394,
+    85899346, 82595525, 81037119, 78090314, 75350303, 72796056, 70409300, 68174084,
+    66076420, 64103989, 62245903, 59652324, 58040099, 55778796, 54366675, 52377650,
+    51130563, 49367440, 47721859, 46182444, 44739243, 43383508, 41698712, 40518559,
+    39045157, 38008560, 36709122, 35495597, 34359738, 33294320, 32292987, 31122951,
+    30246249, 29217465, 28256364, 27356480, 26512144, 25565282, 24826401, 23994231,
+    23216039, 22486740, 21801864, 21053761, 20452225, 19792476, 19088744, 18512790,
+    17895697, 17318417, 16777216, 16268816, 15732481, 15230380, 14708792, 14268994,
+    13810184, 13338408, 12936648, 12521771, 12098499, 11734883, 11332368, 10984571,
+    10631107, 10275041, 9965121, 9629972, 9316632, 9023041, 8729608, 8454660,
+    8180890, 7924294, 7669584, 7417906, 7182220, 6949785, 6731924, 6517401,
+    6306854, 6100806, 5907795, 5718998, 5534752, 5355321, 5187159, 5017485,
+    4858560, 4699089, 4549753, 4405095, 4265112, 4125809, 3995318, 3865857,
+    3741261, 3621389, 3506096, 3392549, 3283614, 3179102, 3076624, 2978479,
+    2882528, 2790752, 2699539, 2614101, 2529427, 2448670, 2370291, 2294320,
+    2220769, 2148558, 2079887, 2013581, 1948715, 1886239, 1825315, 1766749,
+    1710461, 1655731, 1602600, 1551090, 1501212, 1452966, 1406342, 1361321,
+    1317475, 1275228, 1234186, 1194706, 1156426, 1119356, 1083220, 1048576
+};
+
+/**
+ * @brief Calculate the change of the glide value for one update in exponential mode
+ * @param params Struct holding glide parameters
+ * @param state Struct holding glide state
+ * @return Change of the glide value in Q16.16 format
+ */
+static inline int32_t calcGlideStepExponential(
+        const GlideParams * const params,
+        const GlideState * const state)
+{
+    // Calc difference to final value
+    const int16_t noteDiff = params->note - state->value.high;
+
+    // Weight difference value with rate value
+    return __builtin_mulsu(noteDiff, params->rate);
+}
+
+/**
+ * @brief Calculate the change of the glide value for one update in linear rate mode
+ * @param params Struct holding glide parameters
+ * @param state Struct holding glide state
+ * @return Change of the glide value in Q16.16 format
+ */
+static inline int32_t calcGlideStepLinearRate(
+        const GlideParams * const params,
+        const GlideState * const state)
+{
+    Long target = {.value = 0};
+    target.high = params->note;
+
+    // Limit difference to final value to the glide rate
+    const int32_t diff = target.value - state->value.value;
+    const int32_t maxStep = (int32_t) params->rate << 8;
+    if (diff > maxStep)
+    {
+        return maxStep;
+    }
+    else if (diff < -maxStep)
+    {
+        return -maxStep;
+    }
+
+    return diff;
+}
+
+/**
+ * @brief Calculate the change of the glide value for one update in constant time mode
+ * 
+ * A new glide starts when the final note changes. The increment per update is calculated once per glide using
+ * the reciprocal table, the last update snaps to the final note
+ * @param params Struct holding glide parameters
+ * @param state Struct holding glide state
+ * @return Change of the glide value in Q16.16 format
+ */
+static inline int32_t calcGlideStepConstantTime(
+        const GlideParams * const params,
+        GlideState * const state)
+{
+    Long target = {.value = 0};
+    target.high = params->note;
+
+    // Start new glide on note change
+    if (params->note != state->note)
+    {
+        const uint16_t index = params->rate >> 8;
+        state->note = params->note;
+        state->remaining = glideTimeTable[index];
+        // Increment = Diff / Time in Q16.16 format, calculated as (Diff * 2^32 / Time) >> 16 with two 16x16 multiplications.
+        // The fractional part of the difference is covered by the final snap to the target note
+        const int16_t diff = params->note - state->value.high;
+        const uint32_t reciprocal = glideTimeReciprocalTable[index];
+        state->increment.value = __builtin_mulsu(diff, (uint16_t) (reciprocal >> 16))
+                + (__builtin_mulsu(diff, (uint16_t) reciprocal) >> 16);
+    }
+
+    if (state->remaining > 1)
+    {
+        state->remaining--;
+        return state->increment.value;
+    }
+
+    // Last update of the glide snaps to the final note
+    state->remaining = 0;
+    return target.value - state->value.value;
+}
+
+/**
+ * @brief Calculate the change of the glide value for one update
+ * @param params Struct holding glide parameters
+ * @param state Struct holding glide state
+ * @return Change of the glide value in Q16.16 format
+ */
+static inline int32_t calcGlideStep(
+        const GlideParams * const params,
+        GlideState * const state)
+{
+    switch (params->mode)
+    {
+        case GLIDE_MODE_LINEAR_RATE:
+            return calcGlideStepLinearRate(params, state);
+
+        case GLIDE_MODE_CONSTANT_TIME:
+            return calcGlideStepConstantTime(params, state);
+
+        case GLIDE_MODE_EXPONENTIAL:
+        default:
+            return calcGlideStepExponential(params, state);
+    }
+}
+
 /**
  * @brief Update Glide
  * 
  * Update the Glide state from glide transition parameters and return the output value calculated from the updated state
- * @param params Struct holding ADSR envelope parameters
- * @param state Struct holding ADSR envelope state
+ * @param params Struct holding glide parameters
+ * @param state Struct holding glide state
  * @return Glide output value in half-cent format
  */
 int16_t updateGlide(
         const GlideParams * const params,
         GlideState * const state)
+{
+    // Advance glide value according to glide mode
+    state->value.value += calcGlideStep(params, state);
+
+    return state->value.high;
+}
+
+/**
+ * @brief Update Glide for one block of samples
+ * 
+ * Update the Glide state once per block like updateGlide() and write a linear ramp from the previous to the updated
+ * output value, so long glides do not step at block boundaries. The last sample equals the value updateGlide() would return
+ * @param params Struct holding glide parameters
+ * @param state Struct holding glide state
+ * @param data Buffer of BLOCK_LEN samples to be filled with glide output values in half-cent format
+ */
+void updateGlideBlock(
+        const GlideParams * const params,
+        GlideState * const state,
+        int16_t * data)
 {
     // Read state
     Long value = state->value;
-    
-    // Calc difference to final value
-    const int16_t noteDiff = params->note - value.high;
-    
-    // Weight difference value with rate value and add to state
-    value.value += __builtin_mulsu(noteDiff, params->rate);
-    
-    // Write back state
+
+    // Calc change of glide value once per block
+    const int32_t step = calcGlideStep(params, state);
+
+    // Spread the step evenly over the block
+    calcRampBlock(
+            value.value,
+            calcRampIncrement(step >> 1),
+            (uint16_t *) data);
+
+    // Write back state, the exact step avoids accumulation of the ramp rounding error
+    value.value += step;
     state->value = value;
-    
-    return value.high;
-}
\ No newline at end of file
+
+    // Last sample equals the updated output value
+    data[BLOCK_LEN - 1] = value.high;
+}
@@ -0,0 +1,33 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file halfband.c
+ * @brief Coefficients of polyphase halfband filter
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "halfband.h"
+#include "fp_lib_types.h"
+
+/**
+ * @brief Halfband filter coefficients (unique side coefficients from outer to inner tap, followed by center coefficient)
+ *
+ * 15-tap windowed sinc (Kaiser window, beta = 4), side coefficients normalized to a sum of 0.5
+ */
+const _Q15 halfbandCoeffs[HALFBAND_COEFF_BUFFER_LEN] = {-132, 766, -2495, 10053, 16384};
@@ -28,12 +28,12 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #include "osc_rect.h"
 #include "osc_tri.h"
 #include "rand.h"
+#include "transport.h"
 #include "fp_lib_interp.h"
 #include "fp_lib_div.h"
 #include "fp_lib_trig.h"
-
-// Forward declaration
-static const _Q15 lfoRateToFreqTable[];
+#include "block_len_def.h"
+#include <stdint.h>
 
 /**
  * @brief Update the phase of an LFO
@@ -69,6 +69,45 @@ static inline void updateLFOPhase(
     state->phase = phase;
 }
 
+/**
+ * @brief Shift the value history of a random LFO and draw the next value
+ * @param state Struct holding the LFO state
+ */
+static inline void updateLFORandomValues(LFOState * const state)
+{
+    state->previousValue = state->lastValue;
+    state->lastValue = state->currentValue;
+    state->currentValue = state->nextValue;
+    state->nextValue = randSample(&state->rand);
+}
+
+/**
+ * @brief Calculate smooth random LFO value
+ * 
+ * The output is interpolated between the last and current value by 4-point Hermite interpolation, so the
+ * slope is continuous at the segment boundaries
+ * @param state Struct holding the LFO state
+ * @param phase Position within the current segment in Q0.16 format
+ * @return LFO output value in Q0.15 format
+ */
+static inline _Q15 calcLFORandomValue(
+        const LFOState * const state,
+        const _Q16 phase)
+{
+    int16_t coeffs[3];
+    calcLFOHermiteCoeffs(
+            state->previousValue,
+            state->lastValue,
+            state->currentValue,
+            state->nextValue,
+            coeffs);
+
+    return calcLFOHermiteSample(
+            coeffs,
+            state->lastValue,
+            phase);
+}
+
 /**
  * @brief Calculate LFO value
  * 
@@ -105,22 +144,23 @@ static inline _Q15 calcLFOValue(
             break;
 
         case ELFO_WAVEFORM_RANDOM:
-            // Update current and last values when phase overflows
+            // Shift value history and draw next value when phase overflows
             if (state->sync)
             {
-                state->lastValue = state->currentValue;
-                state->currentValue = rand();
+                checkRandState(&state->rand);
+                updateLFORandomValues(state);
             }
 
             // Output value is interpolated between the last and current value
-            return interpLinear(state->lastValue, state->currentValue, state->phase);
+            return calcLFORandomValue(state, state->phase);
             break;
 
         case ELFO_WAVEFORM_SAMPLEHOLD:
             // Update value when phase overflows
             if (state->sync)
             {
-                state->currentValue = rand();
+                checkRandState(&state->rand);
+                state->currentValue = randSample(&state->rand);
             }
 
             // Return current value
@@ -157,6 +197,136 @@ _Q15 updateLFO(
             state);
 }
 
+/**
+ * @brief Update LFO at audio rate
+ * 
+ * Update the LFO state from LFO parameters and calculate one block of output values. The phase advances by
+ * the same amount per block as with updateLFO(), spread evenly over the block, so the last output value
+ * matches the value updateLFO() would return
+ * @param params Struct holding LFO parameters
+ * @param state Struct holding LFO state
+ * @param data Buffer of BLOCK_LEN samples to be filled with LFO output values in Q0.15 format
+ */
+void updateLFOBlock(
+        const LFOParams * const params,
+        LFOState * const state,
+        _Q15 * data)
+{
+    // Convert LFO rate to frequency and spread phase increment over the block (extended to 32 bit for precision).
+    // The per-sample increment is rounded down, the exact increment per block is applied to the stored phase
+    const _Q16 blockFreq = interpLUT_256_Q15(lfoRateToFreqTable, params->rate);
+    const uint32_t freq = __builtin_muluu(blockFreq, (uint16_t) (65536UL / BLOCK_LEN));
+    const _Q16 startPhase = state->phase;
+    uint32_t phase = (uint32_t) startPhase << 16;
+
+    // Calculate LFO values for selected waveform
+    switch (params->waveform)
+    {
+        case ELFO_WAVEFORM_SQUARE:
+            // Square
+            for (uint16_t k = 0; k < BLOCK_LEN; k++)
+            {
+                phase += freq;
+                *data++ = calcNaiveRect(phase >> 16, 0x8000);
+            }
+            break;
+
+        case ELFO_WAVEFORM_SAW:
+            // Sawtooth
+            for (uint16_t k = 0; k < BLOCK_LEN; k++)
+            {
+                phase += freq;
+                *data++ = calcNaiveSaw(phase >> 16);
+            }
+            break;
+
+        case ELFO_WAVEFORM_TRI:
+            // Triangle
+            for (uint16_t k = 0; k < BLOCK_LEN; k++)
+            {
+                phase += freq;
+                *data++ = calcNaiveTri(phase >> 16);
+            }
+            break;
+
+        case ELFO_WAVEFORM_SINE:
+            // Sine
+            for (uint16_t k = 0; k < BLOCK_LEN; k++)
+            {
+                phase += freq;
+                *data++ = sin_Q15(phase >> 16);
+            }
+            break;
+
+        case ELFO_WAVEFORM_RANDOM:
+        {
+            // Random values interpolated at audio rate, coefficients are calculated once per segment
+            checkRandState(&state->rand);
+            int16_t coeffs[3];
+            calcLFOHermiteCoeffs(state->previousValue, state->lastValue, state->currentValue, state->nextValue, coeffs);
+
+            for (uint16_t k = 0; k < BLOCK_LEN; k++)
+            {
+                phase += freq;
+
+                // Shift value history and draw next value when phase overflows
+                if (phase < freq)
+                {
+                    updateLFORandomValues(state);
+                    calcLFOHermiteCoeffs(state->previousValue, state->lastValue, state->currentValue, state->nextValue, coeffs);
+                }
+
+                // Output value is interpolated between the last and current value
+                *data++ = calcLFOHermiteSample(coeffs, state->lastValue, phase >> 16);
+            }
+            break;
+        }
+
+        case ELFO_WAVEFORM_SAMPLEHOLD:
+            // Sample & hold
+            checkRandState(&state->rand);
+            for (uint16_t k = 0; k < BLOCK_LEN; k++)
+            {
+                phase += freq;
+
+                // Update value when phase overflows
+                if (phase < freq)
+                {
+                    state->currentValue = randSample(&state->rand);
+                }
+
+                *data++ = state->currentValue;
+            }
+            break;
+
+        default:
+            // Default, should never be hit
+            for (uint16_t k = 0; k < BLOCK_LEN; k++)
+            {
+                phase += freq;
+                *data++ = 0;
+            }
+            break;
+    }
+
+    // Write back LFO state, the phase advances by less than one cycle per block
+    state->phase = startPhase + blockFreq;
+    state->sync = state->phase < startPhase;
+
+    // The exact phase may wrap although the rounded per-sample phase did not, draw the missed random value
+    if (state->sync && (phase >= ((uint32_t) startPhase << 16)))
+    {
+        if (params->waveform == ELFO_WAVEFORM_RANDOM)
+        {
+            updateLFORandomValues(state);
+        }
+        else if (params->waveform == ELFO_WAVEFORM_SAMPLEHOLD)
+        {
+            state->currentValue = randSample(&state->rand);
+        }
+    }
+}
+
 /**
  * @brief Update LFO in hard-sync mode
  * 
@@ -191,6 +361,43 @@ _Q15 updateLFOSync(
             state);
 }
 
+/**
+ * @brief Update LFO synced to transport clock
+ * 
+ * The LFO phase is derived from the transport song position by multiplication with the sync ratio, i.e. without
+ * per-update division. The sync flag is set once per new LFO cycle, backward snaps of the song position do not
+ * trigger it again
+ * @param waveform Selected LFO waveform type
+ * @param state Struct holding LFO state
+ * @param transport Struct holding transport clock state
+ * @param ratio Number of LFO cycles per beat in Q16.16 format, see TRANSPORT_RATIO()
+ * @return LFO output value in Q0.15 format
+ */
+_Q15 updateLFOTransport(
+        const LFOWaveform waveform,
+        LFOState * const state,
+        const TransportState * const transport,
+        const uint32_t ratio)
+{
+    // Derive phase and cycle count from transport clock
+    const ULong position = {.value = calcTransportPosition(transport, ratio)};
+    state->phase = position.low;
+
+    // Sync on every new cycle. A step back by one cycle is a snap of the song position to the beat grid, the cycle
+    // is not counted again when it is reached a second time. Larger steps (e.g. transport reset) restart the count
+    const int16_t cycles = position.high - state->cycle;
+    state->sync = cycles > 0;
+    if (cycles != -1)
+    {
+        state->cycle = position.high;
+    }
+
+    // Calculate LFO output value
+    return calcLFOValue(
+            waveform,
+            state);
+}
+
 /**
  * @brief Update LFO in hard-reset mode
  * 
@@ -219,7 +426,7 @@ _Q15 updateLFOReset(
  * @brief Interpolation table for LFO rate to frequency conversion
  * For calculation of table values see calc_lfo_rate_to_freq_table.m
  */
-static const _Q15 lfoRateToFreqTable[257] = {
+const _Q15 lfoRateToFreqTable[257] = {
     1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
     2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4,
     4, 4, 4, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 7, 7, 7,
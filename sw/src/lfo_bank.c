@@ -0,0 +1,310 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file lfo_bank.c
+ * @brief Implementation of LFO bank
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "lfo_bank.h"
+#include "lfo_bank_types.h"
+#include "lfo.h"
+#include "osc_saw.h"
+#include "osc_rect.h"
+#include "osc_tri.h"
+#include "rand.h"
+#include "fp_lib_interp.h"
+#include "fp_lib_trig.h"
+
+/// Waveform of each waveform group
+static const LFOWaveform groupWaveform[NOF_LFO_BANK_GROUPS] = {
+    ELFO_WAVEFORM_SQUARE,
+    ELFO_WAVEFORM_SAW,
+    ELFO_WAVEFORM_TRI,
+    ELFO_WAVEFORM_SINE,
+    ELFO_WAVEFORM_RANDOM,
+    ELFO_WAVEFORM_SAMPLEHOLD
+};
+
+/**
+ * @brief Sort LFO numbers by waveform group
+ * @param bank Struct holding LFO bank state
+ */
+static void updateLFOBankGroups(LFOBank * const bank)
+{
+    uint16_t len = 0;
+    for (uint16_t group = 0; group < NOF_LFO_BANK_GROUPS; group++)
+    {
+        const uint16_t start = len;
+        for (uint16_t i = 0; i < NOF_LFO_BANK_LFOS; i++)
+        {
+            if (bank->waveform[i] == groupWaveform[group])
+            {
+                bank->groupIndex[len++] = i;
+            }
+        }
+        bank->groupLen[group] = len - start;
+    }
+
+    bank->groupsValid = true;
+}
+
+/**
+ * @brief Update the phase of one LFO of an LFO bank
+ * @param bank Struct holding LFO bank state
+ * @param i LFO number
+ * @return Updated LFO phase in Q0.16 format
+ */
+static inline _Q16 updateLFOBankPhase(
+        LFOBank * const bank,
+        const uint16_t i)
+{
+    const _Q16 phase = bank->phase[i] + bank->freq[i];
+    bank->phase[i] = phase;
+    return phase;
+}
+
+/**
+ * @brief Update all LFOs of the square group
+ * @param bank Struct holding LFO bank state
+ * @param index LFO numbers of the group
+ * @param len Number of LFOs in the group
+ */
+static void updateLFOBankSquare(
+        LFOBank * const bank,
+        const uint16_t * index,
+        const uint16_t len)
+{
+    for (uint16_t k = 0; k < len; k++)
+    {
+        const uint16_t i = index[k];
+        bank->output[i] = calcNaiveRect(updateLFOBankPhase(bank, i), 0x8000);
+    }
+}
+
+/**
+ * @brief Update all LFOs of the sawtooth group
+ * @param bank Struct holding LFO bank state
+ * @param index LFO numbers of the group
+ * @param len Number of LFOs in the group
+ */
+static void updateLFOBankSaw(
+        LFOBank * const bank,
+        const uint16_t * index,
+        const uint16_t len)
+{
+    for (uint16_t k = 0; k < len; k++)
+    {
+        const uint16_t i = index[k];
+        bank->output[i] = calcNaiveSaw(updateLFOBankPhase(bank, i));
+    }
+}
+
+/**
+ * @brief Update all LFOs of the triangle group
+ * @param bank Struct holding LFO bank state
+ * @param index LFO numbers of the group
+ * @param len Number of LFOs in the group
+ */
+static void updateLFOBankTri(
+        LFOBank * const bank,
+        const uint16_t * index,
+        const uint16_t len)
+{
+    for (uint16_t k = 0; k < len; k++)
+    {
+        const uint16_t i = index[k];
+        bank->output[i] = calcNaiveTri(updateLFOBankPhase(bank, i));
+    }
+}
+
+/**
+ * @brief Update all LFOs of the sine group
+ * @param bank Struct holding LFO bank state
+ * @param index LFO numbers of the group
+ * @param len Number of LFOs in the group
+ */
+static void updateLFOBankSine(
+        LFOBank * const bank,
+        const uint16_t * index,
+        const uint16_t len)
+{
+    for (uint16_t k = 0; k < len; k++)
+    {
+        const uint16_t i = index[k];
+        bank->output[i] = sin_Q15(updateLFOBankPhase(bank, i));
+    }
+}
+
+/**
+ * @brief Update all LFOs of the random group
+ * @param bank Struct holding LFO bank state
+ * @param index LFO numbers of the group
+ * @param len Number of LFOs in the group
+ */
+static void updateLFOBankRandom(
+        LFOBank * const bank,
+        const uint16_t * index,
+        const uint16_t len)
+{
+    for (uint16_t k = 0; k < len; k++)
+    {
+        const uint16_t i = index[k];
+        const _Q16 phase = updateLFOBankPhase(bank, i);
+
+        // Shift value history and draw next value when phase overflows
+        if (phase < bank->freq[i])
+        {
+            bank->previousValue[i] = bank->lastValue[i];
+            bank->lastValue[i] = bank->currentValue[i];
+            bank->currentValue[i] = bank->nextValue[i];
+            bank->nextValue[i] = randSample(&bank->rand);
+        }
+
+        // Output value is interpolated between the last and current value by 4-point Hermite interpolation
+        int16_t coeffs[3];
+        calcLFOHermiteCoeffs(bank->previousValue[i], bank->lastValue[i], bank->currentValue[i], bank->nextValue[i], coeffs);
+        bank->output[i] = calcLFOHermiteSample(coeffs, bank->lastValue[i], phase);
+    }
+}
+
+/**
+ * @brief Update all LFOs of the S&H group
+ * @param bank Struct holding LFO bank state
+ * @param index LFO numbers of the group
+ * @param len Number of LFOs in the group
+ */
+static void updateLFOBankSampleHold(
+        LFOBank * const bank,
+        const uint16_t * index,
+        const uint16_t len)
+{
+    for (uint16_t k = 0; k < len; k++)
+    {
+        const uint16_t i = index[k];
+
+        // Update value when phase overflows
+        if (updateLFOBankPhase(bank, i) < bank->freq[i])
+        {
+            bank->currentValue[i] = randSample(&bank->rand);
+        }
+
+        bank->output[i] = bank->currentValue[i];
+    }
+}
+
+/**
+ * @brief Initialize LFO bank
+ *
+ * All LFOs are reset to phase 0, rate 0 and the selected waveform
+ * @param bank Struct holding LFO bank state
+ * @param waveform Initial LFO waveform type for all LFOs
+ */
+void initLFOBank(
+        LFOBank * const bank,
+        const LFOWaveform waveform)
+{
+    const _Q16 freq = interpLUT_256_Q15(lfoRateToFreqTable, 0);
+
+    for (uint16_t i = 0; i < NOF_LFO_BANK_LFOS; i++)
+    {
+        bank->phase[i] = 0;
+        bank->rate[i] = 0;
+        bank->freq[i] = freq;
+        bank->waveform[i] = waveform;
+        bank->currentValue[i] = 0;
+        bank->lastValue[i] = 0;
+        bank->previousValue[i] = 0;
+        bank->nextValue[i] = 0;
+        bank->output[i] = 0;
+    }
+
+    bank->groupsValid = false;
+    initRandState(
+            &bank->rand,
+            0);
+}
+
+/**
+ * @brief Set parameters of one LFO of an LFO bank
+ *
+ * The rate to frequency conversion is only done if the rate has changed. A waveform change regroups the bank
+ * on the next update
+ * @param bank Struct holding LFO bank state
+ * @param index LFO number (index < NOF_LFO_BANK_LFOS)
+ * @param params Struct holding LFO parameters
+ */
+void setLFOBankParams(
+        LFOBank * const bank,
+        const uint16_t index,
+        const LFOParams * const params)
+{
+    if (bank->rate[index] != params->rate)
+    {
+        bank->rate[index] = params->rate;
+        bank->freq[index] = interpLUT_256_Q15(lfoRateToFreqTable, params->rate);
+    }
+
+    if (bank->waveform[index] != params->waveform)
+    {
+        bank->waveform[index] = params->waveform;
+        bank->groupsValid = false;
+    }
+}
+
+/**
+ * @brief Update all LFOs of an LFO bank
+ *
+ * Each waveform group is processed by a dedicated loop without per-LFO waveform dispatch.
+ * The output values are stored in bank->output[], behaving like updateLFO() for each LFO
+ * @param bank Struct holding LFO bank state
+ */
+void updateLFOBank(LFOBank * const bank)
+{
+    typedef void (*UpdateLFOBankGroup)(LFOBank * const, const uint16_t *, const uint16_t);
+
+    // Group update functions in the order of groupWaveform[]
+    static const UpdateLFOBankGroup updateLFOBankGroup[NOF_LFO_BANK_GROUPS] = {
+        updateLFOBankSquare,
+        updateLFOBankSaw,
+        updateLFOBankTri,
+        updateLFOBankSine,
+        updateLFOBankRandom,
+        updateLFOBankSampleHold
+    };
+
+    if (!bank->groupsValid)
+    {
+        updateLFOBankGroups(bank);
+    }
+
+    // Random and S&H groups draw from the shared generator, check its state once per update
+    checkRandState(&bank->rand);
+
+    const uint16_t * index = bank->groupIndex;
+    for (uint16_t group = 0; group < NOF_LFO_BANK_GROUPS; group++)
+    {
+        const uint16_t len = bank->groupLen[group];
+        if (len)
+        {
+            updateLFOBankGroup[group](bank, index, len);
+            index += len;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file mod_matrix.c
+ * @brief Implementation of modulation matrix
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "mod_matrix.h"
+#include "mod_matrix_types.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Compile modulation matrix
+ * 
+ * Call this function whenever the routing table has changed
+ * @param matrix Struct holding modulation matrix
+ * @param program Struct holding compiled modulation matrix
+ */
+void compileModMatrix(
+        const ModMatrix * const matrix,
+        ModMatrixProgram * const program)
+{
+    int16_t * blockRoute = program->blockRoutes;
+    uint16_t nofBlockRoutes = 0;
+    uint16_t nofAudioRoutes = 0;
+
+    for (uint16_t i = 0; (i < matrix->nofRoutes) && (i < NOF_MOD_ROUTES); i++)
+    {
+        const ModRoute * const route = &matrix->route[i];
+
+        // Skip unused and invalid routes
+        if ((route->amount == 0) || (route->source >= NOF_MOD_SOURCES) || (route->destination >= NOF_MOD_DESTINATIONS))
+        {
+            continue;
+        }
+
+        if (route->audioRate)
+        {
+            program->audioRoutes[nofAudioRoutes++] = *route;
+        }
+        else
+        {
+            // Source and destination are stored as byte offsets for indexed addressing
+            *blockRoute++ = route->source * sizeof (_Q15);
+            *blockRoute++ = route->amount;
+            *blockRoute++ = route->destination * sizeof (_Q15);
+            nofBlockRoutes++;
+        }
+    }
+
+    program->nofBlockRoutes = nofBlockRoutes;
+    program->nofAudioRoutes = nofAudioRoutes;
+}
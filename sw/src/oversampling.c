@@ -0,0 +1,116 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file oversampling.c
+ * @brief Implementation of oversampling framework
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "oversampling.h"
+#include "oversampling_types.h"
+#include "halfband.h"
+#include "fp_lib_types.h"
+#include <stdint.h>
+
+/**
+ * @brief Upsampling of one audio channel
+ *
+ * The first stage reads from the input buffer, all other stages work in-place
+ * @param factor Oversampling factor
+ * @param coeffs Halfband filter coefficients as copied by copyHalfbandCoeffs() allocated in y memory
+ * @param state Struct holding oversampling state
+ * @param xBuffer Work buffer of size >= (len << factor) + HALFBAND_INTERP_HISTORY_LEN allocated in x memory
+ * @param input Input buffer of len samples at base rate
+ * @param oversampled Output buffer of len << factor samples, may be the same as input buffer
+ * @param len Number of samples at base rate
+ */
+void calcOversamplingUp(
+        const OversamplingFactor factor,
+        const _Q15 * const coeffs,
+        OversamplingState * const state,
+        _Q15 * const xBuffer,
+        const _Q15 * const input,
+        _Q15 * const oversampled,
+        const uint16_t len)
+{
+    if ((factor == OVERSAMPLING_NONE) && (input != oversampled))
+    {
+        copyHalfbandBuffer(
+                input,
+                oversampled,
+                len);
+    }
+
+    const _Q15 * stageInput = input;
+    uint16_t stage;
+    for (stage = 0; stage < factor; ++stage)
+    {
+        calcHalfbandInterp2x(
+                coeffs,
+                &state->interp[stage],
+                xBuffer,
+                stageInput,
+                oversampled,
+                len << stage);
+
+        stageInput = oversampled;
+    }
+}
+
+/**
+ * @brief Downsampling of one audio channel
+ *
+ * The last stage writes to the output buffer, all other stages work in-place
+ * @param factor Oversampling factor
+ * @param coeffs Halfband filter coefficients as copied by copyHalfbandCoeffs() allocated in y memory
+ * @param state Struct holding oversampling state
+ * @param xBuffer Work buffer of size >= (len << factor) + HALFBAND_DECIM_HISTORY_LEN allocated in x memory
+ * @param oversampled Input buffer of len << factor samples, will be overwritten
+ * @param output Output buffer of len samples at base rate, may be the same as oversampled buffer
+ * @param len Number of samples at base rate
+ */
+void calcOversamplingDown(
+        const OversamplingFactor factor,
+        const _Q15 * const coeffs,
+        OversamplingState * const state,
+        _Q15 * const xBuffer,
+        _Q15 * const oversampled,
+        _Q15 * const output,
+        const uint16_t len)
+{
+    if ((factor == OVERSAMPLING_NONE) && (oversampled != output))
+    {
+        copyHalfbandBuffer(
+                oversampled,
+                output,
+                len);
+    }
+
+    uint16_t stage = factor;
+    while (stage-- > 0)
+    {
+        calcHalfbandDecim2x(
+                coeffs,
+                &state->decim[stage],
+                xBuffer,
+                oversampled,
+                stage > 0 ? oversampled : output,
+                len << stage);
+    }
+}
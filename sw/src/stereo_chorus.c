@@ -180,8 +180,16 @@ void addStereoChorus(
     ////////////////////////////////////////////////////////////////////////////
     // Calc current delay from LFO
     static LFOState lfoState; // No need to init, TODO in chorus state verschieben
-    const LFOParams sLFOParams = {.waveform = ELFO_WAVEFORM_RANDOM, .rate = params->rate};
-    const _Q15 lfoValue = updateLFO(&sLFOParams, &lfoState);
+    _Q15 lfoValue;
+    if (params->transport)
+    {
+        lfoValue = updateLFOTransport(ELFO_WAVEFORM_RANDOM, &lfoState, params->transport, params->syncRatio);
+    }
+    else
+    {
+        const LFOParams sLFOParams = {.waveform = ELFO_WAVEFORM_RANDOM, .rate = params->rate};
+        lfoValue = updateLFO(&sLFOParams, &lfoState);
+    }
 
     // Split up the total modulation amount (given by LFO value) into common and differential modulation amount
     const _Q15 diffModAmount = mul_Q15_Q16(lfoValue, params->spread); // Total Mod Amount * Spread
@@ -68,16 +68,90 @@ inline static void calcDelayLineInput(
             );
 }
 
+/**
+ * @brief Calculate the delay line input at reduced sample rate from the direct path and delay line signals
+ * 
+ * The delay line holds one sample per 2^rate samples of the direct path. The delay line output is upsampled by linear
+ * interpolation before it is added to the direct path, and the direct path is downsampled by averaging before it is
+ * fed into the delay line. Both are cheap approximations of a halfband filter, so some aliasing and imaging remains.
+ * The brightness filter runs on the delay line samples only, i.e. it attenuates aliasing components which are fed
+ * back, but not the imaging components of the interpolated delay line output which is added to the direct path.
+ * @param directPath Input/output signal for direct path (BLOCK_LEN samples)
+ * @param delayLine Input/output signal for delay line (BLOCK_LEN >> rate samples)
+ * @param last Last delay line output sample of the previous block at half scale
+ * @param feedback Feedback amount, i.e. amount of delay line signal which is fed back into the delay line
+ * @param mix Dry/Wet mix, i.e. amount of delay line signal which is added to the direct path signal
+ * @param rate Delay line sample rate (STEREO_DELAY_RATE_HALF or STEREO_DELAY_RATE_QUARTER)
+ */
+inline static void calcDecimatedDelayLineInput(
+        _Q15 * directPath,
+        _Q15 * delayLine,
+        _Q15 * const last,
+        const _Q15 feedback,
+        const _Q15 mix,
+        const StereoDelayRate rate)
+{
+    // The interpolated value is kept at half scale, so the interpolation increment can never overflow
+    _Q15 interp = *last;
+    
+    // for each delay line sample d[j]:
+    //   step = (d[j] - d[j-1]) / 2^rate
+    //   for each of the 2^rate direct path samples x[k]:
+    //     sum += x[k]
+    //     interp += step
+    //     x[k] += interp * mix
+    //   d[j] = sum / 2^rate + d[j] * feedback
+    __asm__ volatile(
+            "\
+        do      %[outerLen], calcDecDelayLineInput_%=   ;Init outer loop over delay line samples \n \
+                                                        ;\n \
+        mov     [%[delayLine]], w4                      ;Prefetch delayLine[j] \n \
+        lac     w4, #1, A                               ;AccA = 0.5 * delayLine[j] \n \
+        lac     %[interp], #0, B                        ;AccB = 0.5 * delayLine[j-1] \n \
+        sub     A                                       ;AccA = 0.5 * (delayLine[j] - delayLine[j-1]) \n \
+        sftac   A, %[shift]                             ;AccA /= 2^rate \n \
+        sac     A, #0, w0                               ;w0 = interpolation increment \n \
+        clr     B                                       ;AccB = 0 \n \
+                                                        ;\n \
+        do      %[innerLen], calcDecDelayLineInputInner_%= ;Init inner loop over direct path samples \n \
+        add     [%[directPath]], #0, B                  ;AccB += directPath[k] \n \
+        add     %[interp], w0, %[interp]                ;interp += increment \n \
+        mpy     %[interp] * %[mix], A                   ;AccA = 0.5 * interp * mix \n \
+        sftac   A, #-1                                  ;AccA = interp * mix \n \
+        add     [%[directPath]], #0, A                  ;AccA += directPath[k] \n \
+    calcDecDelayLineInputInner_%=:                      ;\n \
+        sac.r   A, #0, [%[directPath]++]                ;directPath[k++] = AccA \n \
+                                                        ;\n \
+        asr     w4, %[interp]                           ;Re-sync interp to 0.5 * delayLine[j] \n \
+        sftac   B, %[shift]                             ;AccB = average of directPath \n \
+        mac     w4 * %[feedback], B                     ;AccB += delayLine[j] * feedback \n \
+                                                        ;\n \
+    calcDecDelayLineInput_%=:                           ;\n \
+        sac.r   B, #0, [%[delayLine]++]                 ;delayLine[j++] = AccB \n \
+                                                        ;\n \
+        ; 2 + (BLOCK_LEN >> rate) * (14 + 6 * 2^rate) cycles total"
+            : [directPath]"+r"(directPath), [delayLine]"+r"(delayLine), [interp]"+z"(interp) /*out*/
+            : [outerLen]"r"((BLOCK_LEN >> rate) - 1), [innerLen]"r"((1 << rate) - 1), [shift]"r"(rate),
+              [feedback]"z"(feedback), [mix]"z"(mix) /*in*/
+            : "w0", "w4" /*clobbered*/
+            );
+    
+    // Store last delay line output sample
+    *last = interp;
+}
+
 /**
  * @brief Add stereo spread to feedback path
  * @param dataLeft Input/output buffer for left stereo channel
  * @param dataRight Input/output buffer for right stereo channel
  * @param spread Stereo spreading factor (0 = no spread ... 1 = stereo inversion/ping-pong)
+ * @param len Number of samples per channel
  */
 inline static void addStereoSpread(
         _Q15 * dataLeft,
         _Q15 * dataRight,
-        const _Q15 spread)
+        const _Q15 spread,
+        const uint16_t len)
 {
     // temp1 = dataLeft[k] * (1 - spread) + dataRight[k] * spread
     // temp2 = dataRight[k] * (1 - spread) + dataLeft[k] * spread
@@ -85,7 +159,7 @@ inline static void addStereoSpread(
     // dataRight[k] = temp2
     __asm__ volatile(
             "\
-        do      #%[len] - 1, addStereoSpread_%=     ;Init loop \n \
+        do      %[len], addStereoSpread_%=          ;Init loop \n \
                                                     ;\n \
         mov     [%[dataLeft]], w4                   ;Prefetch dataLeft[k] \n \
         lac     w4, #0, A                           ;AccA = dataLeft[k] \n \
@@ -103,43 +177,62 @@ inline static void addStereoSpread(
                                                     ;\n \
         sac.r   B, #0, [%[dataRight]++]             ;dataRight[k] = AccB \n \
                                                     ;\n \
-        ; 4 + 10 * BLOCK_LEN cycles total"
+        ; 4 + 10 * len cycles total"
             : [dataLeft]"+r"(dataLeft), [dataRight]"+r"(dataRight) /*out*/
-            : [len]"i"(BLOCK_LEN), [spread]"z"(spread) /*in*/
+            : [len]"r"(len - 1), [spread]"z"(spread) /*in*/
             : "w4" /*clobbered*/
             );
 }
 
 /**
  * @brief Add brightness to stereo signal
+ *
+ * The cut-off note is shifted up by one octave per halving of the delay line rate, so the cut-off frequency of the
+ * brightness filter does not depend on the delay line rate (up to the highest cut-off of the filter)
  * @param brightness Brightness factor in Q0.16  format (0 = darkest ... 1 = brightest)
+ * @param rate Delay line sample rate
  * @param stateLeft brightness filter state for left stereo channel
  * @param stateRight brightness filter state for right stereo channel
  * @param dataLeft Input/output buffer for left stereo channel in Q0.15 format
  * @param dataRight Input/output buffer for right stereo channel in Q0.15 format
+ * @param len Number of samples per channel
  */
 inline static void addBrightness(
         const _Q16 brightness,
+        const StereoDelayRate rate,
         IIROnePoleState * const stateLeft,
         IIROnePoleState * const stateRight,
         _Q15 * const dataLeft,
-        _Q15 * const dataRight)
+        _Q15 * const dataRight,
+        const uint16_t len)
 {
+    // The lower 15 bits of brightness are the cut-off note in cents (see calcVario1PoleParams()), the MSB is the
+    // filter type. 1200 cents per octave
+    const uint16_t cutOff = brightness & 0x7FFF;
+    const uint16_t shift = 1200 * rate;
+    const _Q16 shape = (brightness & 0x8000) | ((cutOff < 0x7FFF - shift) ? cutOff + shift : 0x7FFF);
+
     Vario1PoleParams params;
     calcVario1PoleParams(
-            brightness,
+            shape,
             &params);
 
-    calcVario1PoleStereoBlock(
+    calcVario1PoleStereoBlockLen(
             &params,
             stateLeft,
             stateRight,
             dataLeft,
-            dataRight);
+            dataRight,
+            len);
 }
 
 /**
  * @brief Add delay to stereo signal
+ * @note The delay line buffers hold BLOCK_LEN >> params->rate samples, i.e. the delay line runs at reduced sample rate
+ * for STEREO_DELAY_RATE_HALF and STEREO_DELAY_RATE_QUARTER. This multiplies the maximum delay time for a given delay
+ * memory by 2 or 4 at the cost of bandwidth. The brightness filter cut-off is compensated for the delay line rate
+ * @note The delay time is given by the caller's delay line memory management. For tempo-synced delay times the number
+ * of delay blocks can be taken from calcTransportDelayBlocks() in transport.h
  * @param params Struct holding stereo delay parameters
  * @param state Struct holding stereo delay state
  * @param delayLineLeft Input/output buffer for left delay line
@@ -155,31 +248,62 @@ void addStereoDelay(
         _Q15 * const dataLeft,
         _Q15 * const dataRight)
 {
-    // Delay line input for left channel (SRAM0))
-    calcDelayLineInput(
-            dataLeft,
-            delayLineLeft,
-            params->feedback,
-            params->mix);    
+    const StereoDelayRate rate = params->rate;
+    
+    if (rate == STEREO_DELAY_RATE_FULL)
+    {
+        // Delay line input for left channel (SRAM0))
+        calcDelayLineInput(
+                dataLeft,
+                delayLineLeft,
+                params->feedback,
+                params->mix);    
 
-    // Delay line input for right channel (SRAM1)
-    calcDelayLineInput(
-            dataRight,
-            delayLineRight,
-            params->feedback,
-            params->mix);
+        // Delay line input for right channel (SRAM1)
+        calcDelayLineInput(
+                dataRight,
+                delayLineRight,
+                params->feedback,
+                params->mix);
+    }
+    else
+    {
+        // Delay line input for left channel at reduced rate (SRAM0))
+        calcDecimatedDelayLineInput(
+                dataLeft,
+                delayLineLeft,
+                &state->lastLeft,
+                params->feedback,
+                params->mix,
+                rate);    
+
+        // Delay line input for right channel at reduced rate (SRAM1)
+        calcDecimatedDelayLineInput(
+                dataRight,
+                delayLineRight,
+                &state->lastRight,
+                params->feedback,
+                params->mix,
+                rate);
+    }
+
+    // Feedback path runs at delay line rate
+    const uint16_t delayLineLen = BLOCK_LEN >> rate;
 
     // Add Brightness to feedback signal 
     addBrightness(
             params->brightness,
+            rate,
             &state->filterStateLeft,
             &state->filterStateRight,
             delayLineLeft,
-            delayLineRight);
+            delayLineRight,
+            delayLineLen);
 
     // Add stereo spread (ping-pong) to feedback signal)
     addStereoSpread(
             delayLineLeft,
             delayLineRight,
-            params->spread);
+            params->spread,
+            delayLineLen);
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file stereo_distortion.c
+ * @brief Implementation of oversampled stereo distortion effect
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "stereo_distortion.h"
+#include "stereo_distortion_types.h"
+#include "halfband.h"
+#include "oversampling.h"
+#include "fp_lib_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+
+/**
+ * @brief In-place calculation of oversampled distortion for one stereo channel
+ * @param params Struct holding distortion parameters
+ * @param state Oversampling state of the stereo channel
+ * @param xBuffer Work buffer of size >= 4 * BLOCK_LEN + HALFBAND_DECIM_HISTORY_LEN allocated in x memory
+ * @param coeffs Halfband filter coefficients allocated in y memory
+ * @param oversampled Work buffer of size >= 4 * BLOCK_LEN for oversampled audio data
+ * @param data Audio data of BLOCK_LEN samples
+ */
+static void calcDistortionOversampled(
+        const DistortionParams * const params,
+        OversamplingState * const state,
+        _Q15 * const xBuffer,
+        const _Q15 * const coeffs,
+        _Q15 * const oversampled,
+        _Q15 * const data)
+{
+    const OversamplingFactor factor = (OversamplingFactor) params->oversampling;
+
+    calcOversamplingUp(
+            factor,
+            coeffs,
+            state,
+            xBuffer,
+            data,
+            oversampled,
+            BLOCK_LEN);
+
+    calcDistortion(
+            params,
+            oversampled,
+            BLOCK_LEN << factor);
+
+    calcOversamplingDown(
+            factor,
+            coeffs,
+            state,
+            xBuffer,
+            oversampled,
+            data,
+            BLOCK_LEN);
+}
+
+/**
+ * @brief Add oversampled distortion effect to stereo signal
+ *
+ * The distortion is calculated at the sample rate selected by params->oversampling to reduce aliasing.
+ * Each 2x oversampling stage consists of a polyphase halfband interpolator and decimator.
+ * The filter cost per stereo channel is ~26 cycles per sample for 2x and ~78 cycles per sample for 4x oversampling,
+ * the distortion itself is calculated for 2 or 4 times the number of samples
+ * @note The working length of this function is BLOCK_LEN
+ * @param params Struct holding distortion parameters
+ * @param state Struct holding distortion state
+ * @param xBuffer Work buffer of size >= 4 * BLOCK_LEN + HALFBAND_DECIM_HISTORY_LEN allocated in x memory
+ * @param yBuffer Work buffer of size >= HALFBAND_COEFF_BUFFER_LEN allocated in y memory
+ * @param oversampled Work buffer of size >= 4 * BLOCK_LEN for oversampled audio data
+ * @param data Audio data for both stereo channels (2 * BLOCK_LEN samples, left channel block followed by right
+ * channel block)
+ */
+void addStereoDistortionOversampled(
+        const DistortionParams * const params,
+        DistortionState * const state,
+        _Q15 * const xBuffer,
+        _Q15 * const yBuffer,
+        _Q15 * const oversampled,
+        _Q15 * const data)
+{
+    if (params->oversampling == DISTORTION_OVERSAMPLING_NONE)
+    {
+        addStereoDistortion(params, data);
+        return;
+    }
+
+    copyHalfbandCoeffs(yBuffer);
+
+    calcDistortionOversampled(
+            params,
+            &state->oversampling[0],
+            xBuffer,
+            yBuffer,
+            oversampled,
+            data);
+
+    calcDistortionOversampled(
+            params,
+            &state->oversampling[1],
+            xBuffer,
+            yBuffer,
+            oversampled,
+            data + BLOCK_LEN);
+}
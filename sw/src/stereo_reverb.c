@@ -0,0 +1,428 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file stereo_reverb.c
+ * @brief Impementation of stereo reverb effect
+ *
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "stereo_reverb.h"
+#include "stereo_reverb_types.h"
+#include "iir_1pole.h"
+#include "block_len_def.h"
+#include <stdint.h>
+#include "fp_lib_types.h"
+
+/**
+ * @brief Split-up of the delay memory in 1/256 of the total memory size
+ *
+ * Allpass diffusers first, followed by the delay lines of the feedback delay network.
+ * The ratios are chosen such that the delay line lengths have no common divisors (after rounding to odd numbers)
+ */
+static const uint16_t delayMemoryWeights[NOF_REVERB_ALLPASS + NOF_REVERB_DELAY_LINES] = {8, 12, 46, 54, 63, 73};
+
+/**
+ * @brief Calculate mono input signal from stereo signal
+ * @param dataL Audio data for left stereo channel
+ * @param dataR Audio data for right stereo channel
+ * @param mono Output buffer for mono signal
+ */
+inline static void calcMonoInput(
+        const _Q15 * dataL,
+        const _Q15 * dataR,
+        _Q15 * mono)
+{
+    // mono[k] = 0.5 * (dataL[k] + dataR[k])
+    __asm__ volatile(
+            "\
+        do      #%[len] - 1, calcMonoInput_%=       ;Init loop \n \
+        lac     [%[dataL]++], #1, A                 ;AccA = 0.5 * dataL[k] \n \
+        add     [%[dataR]++], #1, A                 ;AccA += 0.5 * dataR[k] \n \
+    calcMonoInput_%=:                               ;\n \
+        sac.r   A, #0, [%[mono]++]                  ;mono[k++] = AccA \n \
+                                                    ;\n \
+        ; 2 + 3 * BLOCK_LEN cycles total"
+            : [dataL]"+r"(dataL), [dataR]"+r"(dataR), [mono]"+r"(mono) /*out*/
+            : [len]"i"(BLOCK_LEN) /*in*/
+            : /*clobbered*/
+            );
+}
+
+/**
+ * @brief In-place filtering of a contiguous block of samples with Schroeder allpass filter
+ * @param g Allpass gain in Q0.15 format
+ * @param delay Pointer to the current position within the allpass delay line
+ * @param data Input/output buffer
+ * @param len Number of samples (len > 0)
+ */
+inline static void calcAllpassSegment(
+        const _Q15 g,
+        _Q15 * delay,
+        _Q15 * data,
+        const uint16_t len)
+{
+    // y[k] = d[k] - g * x[k]
+    // d[k] = x[k] + g * y[k]
+    __asm__ volatile(
+            "\
+        do      %[len], calcAllpassSegment_%=       ;Init loop \n \
+        mov     [%[delay]], w4                      ;Prefetch d[k] \n \
+        mov     [%[data]], w5                       ;Prefetch x[k] \n \
+        lac     w4, #0, A                           ;AccA = d[k] \n \
+        msc     w5 * %[g], A                        ;AccA -= x[k] * g \n \
+        sac.r   A, #0, w4                           ;w4 = y[k] \n \
+        mpy     w4 * %[g], B                        ;AccB = y[k] * g \n \
+        add     w5, #0, B                           ;AccB += x[k] \n \
+        sac.r   B, #0, [%[delay]++]                 ;d[k++] = AccB \n \
+    calcAllpassSegment_%=:                          ;\n \
+        mov     w4, [%[data]++]                     ;x[k++] = y[k] \n \
+                                                    ;\n \
+        ; 2 + 9N cycles total"
+            : [delay]"+r"(delay), [data]"+r"(data) /*out*/
+            : [len]"r"(len - 1), [g]"z"(g) /*in*/
+            : "w4", "w5" /*clobbered*/
+            );
+}
+
+/**
+ * @brief Read a contiguous block of samples from a delay line and apply gain
+ * @param src Pointer to the current position within the delay line
+ * @param gain Gain in Q0.15 format
+ * @param dst Output buffer
+ * @param len Number of samples (len > 0)
+ */
+inline static void readDelayLineSegment(
+        const _Q15 * src,
+        const _Q15 gain,
+        _Q15 * dst,
+        const uint16_t len)
+{
+    __asm__ volatile(
+            "\
+        do      %[len], readDelayLineSegment_%=     ;Init loop \n \
+        mov     [%[src]++], w4                      ;Prefetch src[k++] \n \
+        mpy     w4 * %[gain], A                     ;AccA = src[k] * gain \n \
+    readDelayLineSegment_%=:                        ;\n \
+        sac.r   A, #0, [%[dst]++]                   ;dst[k++] = AccA \n \
+                                                    ;\n \
+        ; 2 + 3N cycles total"
+            : [src]"+r"(src), [dst]"+r"(dst) /*out*/
+            : [len]"r"(len - 1), [gain]"z"(gain) /*in*/
+            : "w4" /*clobbered*/
+            );
+}
+
+/**
+ * @brief Write a contiguous block of samples to a delay line
+ * @param src Input buffer
+ * @param dst Pointer to the current position within the delay line
+ * @param len Number of samples (len > 0)
+ */
+inline static void writeDelayLineSegment(
+        const _Q15 * src,
+        _Q15 * dst,
+        const uint16_t len)
+{
+    __asm__ volatile(
+            "\
+        repeat  %[len]                      ;\n \
+        mov     [%[src]++], [%[dst]++]      ;\n \
+        ; 1 + N cycles total"
+            : [dst] "+r"(dst), [src] "+r"(src) /*out*/
+            : [len] "r"(len - 1) /*in*/
+            : /*clobbered*/
+            );
+}
+
+/**
+ * @brief Add the output of two delay lines to one stereo channel
+ * @param lineA First delay line output
+ * @param lineB Second delay line output
+ * @param mix Reverb mix in Q0.15 format
+ * @param data Input/output buffer for stereo channel
+ */
+inline static void addReverbOutput(
+        const _Q15 * lineA,
+        const _Q15 * lineB,
+        const _Q15 mix,
+        _Q15 * data)
+{
+    // data[k] += mix * (lineA[k] + lineB[k])
+    __asm__ volatile(
+            "\
+        do      #%[len] - 1, addReverbOutput_%=     ;Init loop \n \
+        mov     [%[lineA]++], w4                    ;Prefetch lineA[k] \n \
+        mpy     w4 * %[mix], A                      ;AccA = lineA[k] * mix \n \
+        mov     [%[lineB]++], w4                    ;Prefetch lineB[k] \n \
+        mac     w4 * %[mix], A                      ;AccA += lineB[k] * mix \n \
+        add     [%[data]], #0, A                    ;AccA += data[k] \n \
+    addReverbOutput_%=:                             ;\n \
+        sac.r   A, #0, [%[data]++]                  ;data[k++] = AccA \n \
+                                                    ;\n \
+        ; 2 + 6 * BLOCK_LEN cycles total"
+            : [lineA]"+r"(lineA), [lineB]"+r"(lineB), [data]"+r"(data) /*out*/
+            : [len]"i"(BLOCK_LEN), [mix]"z"(mix) /*in*/
+            : "w4" /*clobbered*/
+            );
+}
+
+/**
+ * @brief Calculate the delay line inputs of the feedback delay network
+ *
+ * The delay line outputs are mixed by a 4x4 Householder matrix (I - 0.5 * ones), which is lossless and needs no
+ * multiplications. The input signal is added to all delay lines
+ * @param line0 Input/output buffer for delay line 0
+ * @param line1 Input/output buffer for delay line 1
+ * @param line2 Input/output buffer for delay line 2
+ * @param line3 Input/output buffer for delay line 3
+ * @param input Diffused input signal
+ */
+inline static void calcFeedbackMatrix(
+        _Q15 * line0,
+        _Q15 * line1,
+        _Q15 * line2,
+        _Q15 * line3,
+        const _Q15 * input)
+{
+    // s = 0.5 * (line0[k] + line1[k] + line2[k] + line3[k])
+    // lineN[k] = lineN[k] - s + input[k]
+    __asm__ volatile(
+            "\
+        do      #%[len] - 1, calcFeedbackMatrix_%=  ;Init loop \n \
+        lac     [%[l0]], #1, B                      ;AccB = 0.5 * line0[k] \n \
+        add     [%[l1]], #1, B                      ;AccB += 0.5 * line1[k] \n \
+        add     [%[l2]], #1, B                      ;AccB += 0.5 * line2[k] \n \
+        add     [%[l3]], #1, B                      ;AccB += 0.5 * line3[k] \n \
+                                                    ;\n \
+        lac     [%[l0]], #0, A                      ;AccA = line0[k] \n \
+        sub     A                                   ;AccA -= s \n \
+        add     [%[x]], #0, A                       ;AccA += input[k] \n \
+        sac.r   A, #0, [%[l0]++]                    ;line0[k++] = AccA \n \
+                                                    ;\n \
+        lac     [%[l1]], #0, A                      ;AccA = line1[k] \n \
+        sub     A                                   ;AccA -= s \n \
+        add     [%[x]], #0, A                       ;AccA += input[k] \n \
+        sac.r   A, #0, [%[l1]++]                    ;line1[k++] = AccA \n \
+                                                    ;\n \
+        lac     [%[l2]], #0, A                      ;AccA = line2[k] \n \
+        sub     A                                   ;AccA -= s \n \
+        add     [%[x]], #0, A                       ;AccA += input[k] \n \
+        sac.r   A, #0, [%[l2]++]                    ;line2[k++] = AccA \n \
+                                                    ;\n \
+        lac     [%[l3]], #0, A                      ;AccA = line3[k] \n \
+        sub     A                                   ;AccA -= s \n \
+        add     [%[x]++], #0, A                     ;AccA += input[k++] \n \
+    calcFeedbackMatrix_%=:                          ;\n \
+        sac.r   A, #0, [%[l3]++]                    ;line3[k++] = AccA \n \
+                                                    ;\n \
+        ; 2 + 20 * BLOCK_LEN cycles total"
+            : [l0]"+r"(line0), [l1]"+r"(line1), [l2]"+r"(line2), [l3]"+r"(line3), [x]"+r"(input) /*out*/
+            : [len]"i"(BLOCK_LEN) /*in*/
+            : /*clobbered*/
+            );
+}
+
+/**
+ * @brief Advance the read/write position of a delay line by one block
+ * @param line Delay line
+ */
+inline static void advanceDelayLine(ReverbDelayLine * const line)
+{
+    uint16_t pos = line->pos + BLOCK_LEN;
+    if (pos >= line->len)
+        pos -= line->len;
+    line->pos = pos;
+}
+
+/**
+ * @brief In-place filtering of one block of samples with allpass diffuser
+ * @param g Allpass gain in Q0.15 format
+ * @param line Allpass delay line
+ * @param data Input/output buffer
+ */
+inline static void calcAllpass(
+        const _Q15 g,
+        ReverbDelayLine * const line,
+        _Q15 * const data)
+{
+    // Process one block with at most one wrap-around of the delay line, since len >= BLOCK_LEN
+    const uint16_t nofSamples = line->len - line->pos;
+    if (nofSamples >= BLOCK_LEN)
+    {
+        calcAllpassSegment(g, line->buffer + line->pos, data, BLOCK_LEN);
+    }
+    else
+    {
+        calcAllpassSegment(g, line->buffer + line->pos, data, nofSamples);
+        calcAllpassSegment(g, line->buffer, data + nofSamples, BLOCK_LEN - nofSamples);
+    }
+
+    advanceDelayLine(line);
+}
+
+/**
+ * @brief Read one block of samples from a delay line of the feedback delay network
+ * @param line Delay line
+ * @param gain Gain in Q0.15 format
+ * @param data Output buffer
+ */
+inline static void readDelayLine(
+        const ReverbDelayLine * const line,
+        const _Q15 gain,
+        _Q15 * const data)
+{
+    const uint16_t nofSamples = line->len - line->pos;
+    if (nofSamples >= BLOCK_LEN)
+    {
+        readDelayLineSegment(line->buffer + line->pos, gain, data, BLOCK_LEN);
+    }
+    else
+    {
+        readDelayLineSegment(line->buffer + line->pos, gain, data, nofSamples);
+        readDelayLineSegment(line->buffer, gain, data + nofSamples, BLOCK_LEN - nofSamples);
+    }
+}
+
+/**
+ * @brief Write one block of samples to a delay line of the feedback delay network and advance its position
+ * @param line Delay line
+ * @param data Input buffer
+ */
+inline static void writeDelayLine(
+        ReverbDelayLine * const line,
+        const _Q15 * const data)
+{
+    const uint16_t nofSamples = line->len - line->pos;
+    if (nofSamples >= BLOCK_LEN)
+    {
+        writeDelayLineSegment(data, line->buffer + line->pos, BLOCK_LEN);
+    }
+    else
+    {
+        writeDelayLineSegment(data, line->buffer + line->pos, nofSamples);
+        writeDelayLineSegment(data + nofSamples, line->buffer, BLOCK_LEN - nofSamples);
+    }
+
+    advanceDelayLine(line);
+}
+
+/**
+ * @brief Initialize stereo reverb state
+ *
+ * The caller-supplied memory is split up into the allpass diffusers and the delay lines of the feedback delay network.
+ * The room size scales with the amount of memory, e.g. 8192 words correspond to a longest delay line of ~50 ms @ 48 kHz
+ * @param state Struct holding stereo reverb state
+ * @param memory Delay memory, will be cleared
+ * @param size Size of delay memory in words
+ * @note size must be >= 32 * (BLOCK_LEN + 1), so that the shortest delay line holds at least one block (not checked)
+ */
+void initStereoReverb(
+        StereoReverbState * const state,
+        _Q15 * const memory,
+        const uint16_t size)
+{
+    // Clear delay memory
+    for (uint16_t cSample = 0; cSample < size; ++cSample)
+    {
+        memory[cSample] = 0;
+    }
+
+    // Split up delay memory. Delay line lengths are odd numbers
+    _Q15 * buffer = memory;
+    for (uint16_t cLine = 0; cLine < NOF_REVERB_ALLPASS + NOF_REVERB_DELAY_LINES; ++cLine)
+    {
+        ReverbDelayLine * const line = (cLine < NOF_REVERB_ALLPASS) ?
+                &state->allpass[cLine] :
+                &state->delayLine[cLine - NOF_REVERB_ALLPASS];
+
+        const uint16_t len = ((uint16_t) (__builtin_muluu(size, delayMemoryWeights[cLine]) >> 8) - 1) | 1;
+        line->buffer = buffer;
+        line->len = len;
+        line->pos = 0;
+        buffer += len;
+    }
+
+    // Clear damping filter states
+    for (uint16_t cLine = 0; cLine < NOF_REVERB_DELAY_LINES; ++cLine)
+    {
+        state->damping[cLine].stateValue = 0;
+        state->damping[cLine].stateScaling = 0;
+    }
+}
+
+/**
+ * @brief Add reverb to stereo signal
+ *
+ * Mono input is diffused by two allpass filters and fed into a 4-line feedback delay network with Householder
+ * feedback matrix and 1-pole damping in each line
+ * @note The working length of this function is BLOCK_LEN
+ * @note The processing cost is ~120 cycles per stereo sample plus ~150 cycles per block
+ * @param params Struct holding stereo reverb parameters
+ * @param state Struct holding stereo reverb state
+ * @param dataL Audio data for left stereo channel
+ * @param dataR Audio data for right stereo channel
+ */
+void addStereoReverb(
+        const StereoReverbParams * const params,
+        StereoReverbState * const state,
+        _Q15 * dataL,
+        _Q15 * dataR)
+{
+    _Q15 input[BLOCK_LEN];
+    _Q15 lines[NOF_REVERB_DELAY_LINES][BLOCK_LEN];
+
+    // Step 1: Mono input, diffused by allpass filters (~21 cycles per sample)
+    calcMonoInput(dataL, dataR, input);
+    for (uint16_t cAllpass = 0; cAllpass < NOF_REVERB_ALLPASS; ++cAllpass)
+    {
+        calcAllpass(
+                params->diffusion,
+                &state->allpass[cAllpass],
+                input);
+    }
+
+    // Step 2: Read delay line outputs with decay gain and apply damping (~56 cycles per sample)
+    // Since all delay lines are longer than one block, the complete block can be read before anything is written
+    const _Q15 alpha = calcIIR1PoleAlpha(params->brightness);
+    for (uint16_t cLine = 0; cLine < NOF_REVERB_DELAY_LINES; ++cLine)
+    {
+        readDelayLine(
+                &state->delayLine[cLine],
+                params->decay,
+                lines[cLine]);
+
+        calcLP1PoleBlock(
+                alpha,
+                &state->damping[cLine],
+                lines[cLine]);
+    }
+
+    // Step 3: Add reverb output to stereo signal (~12 cycles per sample)
+    addReverbOutput(lines[0], lines[2], params->mix, dataL);
+    addReverbOutput(lines[1], lines[3], params->mix, dataR);
+
+    // Step 4: Feedback matrix and delay line input (~24 cycles per sample)
+    calcFeedbackMatrix(lines[0], lines[1], lines[2], lines[3], input);
+    for (uint16_t cLine = 0; cLine < NOF_REVERB_DELAY_LINES; ++cLine)
+    {
+        writeDelayLine(
+                &state->delayLine[cLine],
+                lines[cLine]);
+    }
+}
@@ -24,6 +24,7 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "tone_control_2band.h"
 #include "tone_control_2band_types.h"
+#include "param_cache.h"
 #include "fp_lib_types.h"
 #include "fp_lib_mul.h"
 #include "block_len_def.h"
@@ -77,86 +78,148 @@ static inline void calcTrebleCoeffs(
 }
 
 /**
- * @brief In-place filtering of one block of samples with SVF shelf filter output
+ * @brief Copy filter coefficients of both shelf filters from source to destination buffer
+ * @param src Pointer to source buffer
+ * @param dst Pointer to destination buffer
+ */
+inline static void copyCoeffs(
+        const _Q15 * src,
+        _Q15 * dst)
+{
+    __asm__ volatile(
+            "\
+        repeat  #12-1                      ;\n \
+        mov     [%[src]++], [%[dst]++]     ;\n \
+        ; 13 cycles total"
+            : [dst] "+r"(dst), [src] "+r"(src) /*out*/
+            : /*in*/
+            : /*clobbered*/
+            );
+}
+
+/**
+ * @brief In-place filtering of one block of samples with cascaded high shelf and low shelf SVF filters
  * 
  * Calculation of SVF output according to the notation as found in:\n
  * https://cytomic.com/files/dsp/SvfLinearTrapOptimised2.pdf
- * @param coeffs SVF coefficients in Q0.15 format
- * @param state SVF state in Q0.15 format
+ * 
+ * Both shelf filters are processed per sample within one loop, intermediate values v1 and v2 are kept in registers
+ * @param coeffs SVF coefficients in Q0.15 format, high shelf coefficients followed by low shelf coefficients
+ * @param trebleState High shelf SVF state in Q0.15 format
+ * @param bassState Low shelf SVF state in Q0.15 format
+ * @param xBuffer Work buffer of size >= 4 allocated in x memory
  * @param data  Buffer of BLOCK_LEN samples to be filtered
  */
-static inline void calcShelf2PoleBlockInplace(
-                                           const _Q15 * coeffs,
-                                           _Q15 * state,
-                                           _Q15 * xBuffer,
-                                           _Q15 * data)
+static inline void calcShelf2PoleCascadeBlockInplace(
+                                                     const _Q15 * coeffs,
+                                                     _Q15 * const trebleState,
+                                                     _Q15 * const bassState,
+                                                     _Q15 * xBuffer,
+                                                     _Q15 * data)
 {    
-    xBuffer[0] = state[0];
-    xBuffer[1] = state[1];
+    xBuffer[0] = trebleState[0];
+    xBuffer[1] = trebleState[1];
+    xBuffer[2] = bassState[0];
+    xBuffer[3] = bassState[1];
     
-    _Q15 * v = &xBuffer[2];
+    _Q15 * sTreble = &xBuffer[0];
+    _Q15 * sBass = &xBuffer[2];
+    const _Q15 * aTreble = coeffs;
+    const _Q15 * aBass = coeffs + 6;
 
     // Loop all samples
-    // @todo Utilize x prefetch for v
     __asm__ volatile(
             "\
-        movsac  A, [%[s]]+=2, w4, [%[a]]+=2, w5                                 ;Prefetch s[0+1] and a[0+1] \n \
+        movsac  A, [%[sT]]+=2, w4, [%[aT]]+=2, w5                               ;Prefetch s[0] and a[0] of high shelf \n \
                                                                                 ;\n \
     ;Start processing loop                                                      ;\n \
-        do #%[Len]-1, CalcLS2Pole_%=                                            ;\n \
+        do #%[Len]-1, CalcShelfCascade_%=                                       ;\n \
+                                                                                ;\n \
+    ;High shelf: v1 = a[0] * s[0] - a[1] * s[1] + a[1] * x                      ;\n \
+        mpy     w4 * w5, A, [%[sT]]-=2, w4, [%[aT]]+=2, w5                      ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w4 * w5, A                                                      ;AccA -= s[1] * a[1] \n \
+        mov     [%[x]], w4                                                      ;prefetch x \n \
+        mac     w4 * w5, A, [%[aT]]-=2, w5                                      ;AccA += x * a[1], keep x and prefetch a[2] \n \
+        sac.r   A, #0, w6                                                       ;Store v1 in w6 \n \
+                                                                                ;\n \
+    ;High shelf: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                 ;\n \
+        lac     [%[sT]++], #1, B                                                ;AccB = 0.5 * s[0] \n \
+        sub     A                                                               ;AccA = v1 - 0.5 * s[0] \n \
+                                                                                ;\n \
+    ;High shelf: v2 = x * a[2] - a[2] * s[1] + s[1] + s[0] * a[1]               ;\n \
+        mpy     w4 * w5, B, [%[sT]]-=2, w4                                      ;AccB = x * a[2], prefetch s[1] and keep a[2] \n \
+        add     w4, #0, B                                                       ;AccB += s[1] \n \
+        msc     w4 * w5, B, [%[sT]], w4, [%[aT]]+=6, w5                         ;AccB -= s[1] * a[2], prefetch s[0] and a[1] \n \
+        mac     w4 * w5, B, [%[aT]]+=2, w5                                      ;AccB += s[0] * a[1], prefetch a[4] \n \
+        sac.r   B, #0, w7                                                       ;Store v2 in w7 \n \
                                                                                 ;\n \
-    ;v1 = a[0] * s[0] - a[1] * s[1] + a[1] * x                                  ;\n \
-        mpy     w4 * w5, A, [%[s]]-=2, w4, [%[a]]+=2, w5                        ;AccA = s[0] * a[0], prefetch s[1-1] and a[1-1] \n \
-        msc     w4 * w5, A                                                      ;AccA -= s[1] * a[1], prefetch x and keep a[1] \n \
+        sac.r   A, #-1, [%[sT]++]                                               ;Store AccA * 2 in s[0] \n \
+    ;High shelf: s[1] = 2 * v2 - s[1] = 2 * ( v2 - 0.5 * s[1] )                 ;\n \
+        lac     [%[sT]], #1, A                                                  ;AccA = 0.5 * s[1] \n \
+        sub     B                                                               ;AccB = v2 - 0.5 * s[1] \n \
+        sac.r   B, #-1, [%[sT]--]                                               ;Store AccB * 2 in s[1] \n \
+                                                                                ;\n \
+    ;High shelf: y = x + a[3] * v1 + a[4] * v2                                  ;\n \
+        mpy     w5 * w6, A, [%[aT]]-=4, w5                                      ;AccA = v1 * a[4], prefetch a[5] \n \
+        mac     w5 * w7, A, [%[aT]]-=6, w5                                      ;AccA += v2 * a[5], prefetch a[3] \n \
+        mov     [%[x]], w4                                                      ;prefetch x \n \
+        mac     w4 * w5, A, [%[sB]]+=2, w4, [%[aB]]+=2, w5                      ;AccA += x * a[3], prefetch s[0] and a[0] of low shelf \n \
+        sac.r   A, #-1, [%[x]]                                                  ;Store AccA * 2 in x (* 2 because of filter coefficient scaling) \n \
+                                                                                ;\n \
+    ;Low shelf: v1 = a[0] * s[0] - a[1] * s[1] + a[1] * x                       ;\n \
+        mpy     w4 * w5, A, [%[sB]]-=2, w4, [%[aB]]+=2, w5                      ;AccA = s[0] * a[0], prefetch s[1] and a[1] \n \
+        msc     w4 * w5, A                                                      ;AccA -= s[1] * a[1] \n \
         mov     [%[x]], w4                                                      ;prefetch x \n \
-        mac     w4 * w5, A, [%[a]]-=2, w5                                       ;AccA += x * a[1], keep x and prefetch a[2-1] \n \
-        sac.r   A, #0, [%[v]++]                                                 ;Store AccA in v[0+1] \n \
+        mac     w4 * w5, A, [%[aB]]-=2, w5                                      ;AccA += x * a[1], keep x and prefetch a[2] \n \
+        sac.r   A, #0, w6                                                       ;Store v1 in w6 \n \
                                                                                 ;\n \
-    ;s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                             ;\n \
-        lac     [%[s]++], #1, B                                                 ;AccB = 0.5 * s[0+1] \n \
+    ;Low shelf: s[0] = 2 * v1 - s[0] = 2 * ( v1 - 0.5 * s[0] )                  ;\n \
+        lac     [%[sB]++], #1, B                                                ;AccB = 0.5 * s[0] \n \
         sub     A                                                               ;AccA = v1 - 0.5 * s[0] \n \
                                                                                 ;\n \
-    ;v2 = x * a[2] - a[2] * s[1] + s[1] + s[0] * a[1]                           ;\n \
-        mpy     w4 * w5, B, [%[s]]-=2, w4                                       ;AccB = x * a[2], prefetch s[1-1] and keep a[2-1] \n \
+    ;Low shelf: v2 = x * a[2] - a[2] * s[1] + s[1] + s[0] * a[1]                ;\n \
+        mpy     w4 * w5, B, [%[sB]]-=2, w4                                      ;AccB = x * a[2], prefetch s[1] and keep a[2] \n \
         add     w4, #0, B                                                       ;AccB += s[1] \n \
-        msc     w4 * w5, B, [%[s]], w4, [%[a]]+=6, w5                           ;AccB -= s[1] * a[2], prefetch s[0] and a[1+3] \n \
-        mac     w4 * w5, B, [%[a]]+=2, w5                                       ;AccB += s[0] * a[1], keep x and prefetch a[4+1] \n \
-        sac.r   B, #0, [%[v]--]                                                 ;Store AccB in v[1-1] \n \
+        msc     w4 * w5, B, [%[sB]], w4, [%[aB]]+=6, w5                         ;AccB -= s[1] * a[2], prefetch s[0] and a[1] \n \
+        mac     w4 * w5, B, [%[aB]]+=2, w5                                      ;AccB += s[0] * a[1], prefetch a[4] \n \
+        sac.r   B, #0, w7                                                       ;Store v2 in w7 \n \
                                                                                 ;\n \
-        sac.r   A, #-1, [%[s]++]                                                ;Store AccA * 2 in s[0+1] \n \
-    ;s[1] = 2 * v2 - s[1] = 2 * ( v2 - 0.5 * s[1] )                             ;\n \
-        lac     [%[s]], #1, A                                                   ;AccA = 0.5 * s[1] (Q0.15 --> Q3.12) \n \
-        sub     B                                                               ;AccA = v2 - 0.5 * s[1] \n \
-        sac.r   B, #-1, [%[s]--]                                                ;Store AccB * 2 in s[1-1] \n \
+        sac.r   A, #-1, [%[sB]++]                                               ;Store AccA * 2 in s[0] \n \
+    ;Low shelf: s[1] = 2 * v2 - s[1] = 2 * ( v2 - 0.5 * s[1] )                  ;\n \
+        lac     [%[sB]], #1, A                                                  ;AccA = 0.5 * s[1] \n \
+        sub     B                                                               ;AccB = v2 - 0.5 * s[1] \n \
+        sac.r   B, #-1, [%[sB]--]                                               ;Store AccB * 2 in s[1] \n \
                                                                                 ;\n \
-    ;y = x + a[3] * v1 + a[4] * v2                                              ;\n \
-        mov     [%[v]++], w4                                                    ;prefetch v1 \n \
-        mpy     w4 * w5, A, [%[a]]-=4, w5                                       ;AccA += v1 * a[4], keep v2 and prefetch a[5-2] \n \
-        mov     [%[v]--], w4                                                    ;prefetch v2 \n \
-        mac     w4 * w5, A, [%[a]]-=6, w5                                       ;AccA += v2 * a[5], keep v2 and prefetch a[3-3] \n \
+    ;Low shelf: y = x + a[3] * v1 + a[4] * v2                                   ;\n \
+        mpy     w5 * w6, A, [%[aB]]-=4, w5                                      ;AccA = v1 * a[4], prefetch a[5] \n \
+        mac     w5 * w7, A, [%[aB]]-=6, w5                                      ;AccA += v2 * a[5], prefetch a[3] \n \
         mov     [%[x]], w4                                                      ;prefetch x \n \
-        mac     w4 * w5, A, [%[s]]+=2, w4, [%[a]]+=2, w5                        ;AccA += x * a[3], prefetch s[0+1] and a[0+1] \n \
+        mac     w4 * w5, A, [%[sT]]+=2, w4, [%[aT]]+=2, w5                      ;AccA += x * a[3], prefetch s[0] and a[0] of high shelf for next do-loop iteration \n \
                                                                                 ;\n \
-    CalcLS2Pole_%=:                                                             ;\n \
-        sac.r   A, #-1, [%[x]++]                                                ;Store AccA * 2 in x (* 2 because of filter coefficient scaling) \n \
+    CalcShelfCascade_%=:                                                        ;\n \
+        sac.r   A, #-1, [%[x]++]                                                ;Store AccA * 2 in x, increment x pointer \n \
                                                                                 ;\n \
-        ; 3 + 13N cycles total"
-            : [x]"+r"(data), [s]"+x"(xBuffer), [a]"+y"(coeffs), [v]"+x"(v) /*out*/
+        ; 3 + 42N cycles total"
+            : [x]"+r"(data), [sT]"+x"(sTreble), [sB]"+x"(sBass), [aT]"+y"(aTreble), [aB]"+y"(aBass) /*out*/
             : [Len]"i"(BLOCK_LEN) /*in*/
-            : "w4", "w5" /*clobbered*/
+            : "w4", "w5", "w6", "w7" /*clobbered*/
             );
 
-    state[0] = xBuffer[-1];
-    state[1] = xBuffer[0];
+    trebleState[0] = xBuffer[0];
+    trebleState[1] = xBuffer[1];
+    bassState[0] = xBuffer[2];
+    bassState[1] = xBuffer[3];
 }
 
 /**
  * In-place calculation of 2-band stereo tone control
  * 
+ * Filter coefficients are cached in the state and only recalculated on parameter changes
+ * @note The state must be zero-initialized before first use
  * @param params Struct holding tone control parameters
  * @param state Struct holding tone control state
  * @param xBuffer Work buffer of size >= 4 allocated in x memory
- * @param yBuffer Work buffer of size >= 6 allocated in y memory
+ * @param yBuffer Work buffer of size >= 12 allocated in y memory
  * @param bufferLeft Input/Output buffer for left stereo channel in Q0.15 format
  * @param bufferRight Input/Output buffer for right stereo channel in Q0.15 format
  */
@@ -168,36 +231,37 @@ void calcToneControl2Band(
         _Q15 * const bufferLeft,
         _Q15 * const bufferRight)
 {
-    // Treble / high shelf filter
-    calcTrebleCoeffs(
-            params->treble,
-            yBuffer);
-
-    calcShelf2PoleBlockInplace(
-            yBuffer,
-            state->trebleStateLeft,
-            xBuffer,
-            bufferLeft);
+    // Filter coefficients are only recalculated on parameter changes
+    const uint16_t inputs[] = {params->treble, params->bass};
+    if (updateParamCache(&state->cache, inputs, 2))
+    {
+        // Treble / high shelf filter coefficients
+        calcTrebleCoeffs(
+                params->treble,
+                state->coeffs);
 
-    calcShelf2PoleBlockInplace(
-            yBuffer,
-            state->trebleStateRight,
-            xBuffer,
-            bufferRight);
+        // Bass / low shelf filter coefficients
+        calcBassCoeffs(
+                params->bass,
+                state->coeffs + 6);
+    }
 
-    // Bass / low shelf filter
-    calcBassCoeffs(
-            params->bass,
+    // Copy cached coefficients to y memory
+    copyCoeffs(
+            state->coeffs,
             yBuffer);
 
-    calcShelf2PoleBlockInplace(
+    // Both shelf filters are processed in one pass per stereo channel
+    calcShelf2PoleCascadeBlockInplace(
             yBuffer,
+            state->trebleStateLeft,
             state->bassStateLeft,
             xBuffer,
             bufferLeft);
 
-    calcShelf2PoleBlockInplace(
+    calcShelf2PoleCascadeBlockInplace(
             yBuffer,
+            state->trebleStateRight,
             state->bassStateRight,
             xBuffer,
             bufferRight);
@@ -205,3 +269,4 @@ void calcToneControl2Band(
 
 
 
+
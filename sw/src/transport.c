@@ -0,0 +1,99 @@
+/*
+Copyright (C) 2022 Andreas Lagler
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file transport.c
+ * @brief Implementation of transport clock for tempo-synced modulation
+ * 
+ * This file is part of Synth-Lib fixed-point synthesizer library for dsPIC33 family of Microchip dsPIC digital signal controllers
+ */
+
+#include "transport.h"
+#include "transport_types.h"
+#include "block_len_def.h"
+#include <stdint.h>
+
+/// Number of samples per minute, scaled by 16 for tempo in Q12.4 format
+#define SAMPLES_PER_MINUTE_Q4 (60UL * 16UL * TRANSPORT_SAMPLE_RATE)
+
+/**
+ * @brief Reset transport clock to song position 0, e.g. on MIDI start
+ * @param state Struct holding transport clock state
+ */
+void resetTransport(TransportState * const state)
+{
+    state->phase = 0;
+    state->blockCount = 0;
+    state->clockTick = 0;
+    state->beat = 0;
+}
+
+/**
+ * @brief Set tempo of the internal transport clock
+ * @note This function divides, call it on tempo changes only
+ * @param state Struct holding transport clock state
+ * @param tempo Tempo in beats per minute in Q12.4 format
+ */
+void setTransportTempo(
+        TransportState * const state,
+        const uint16_t tempo)
+{
+    const uint32_t tempoBlockLen = (uint32_t) tempo * BLOCK_LEN;
+
+    if (tempoBlockLen)
+    {
+        state->increment = ((uint64_t) tempoBlockLen << 16) / SAMPLES_PER_MINUTE_Q4;
+        state->blocksPerBeat = ((uint64_t) SAMPLES_PER_MINUTE_Q4 << 16) / tempoBlockLen;
+    }
+    else
+    {
+        // Transport is stopped
+        state->increment = 0;
+        state->blocksPerBeat = 0;
+    }
+}
+
+/**
+ * @brief Process one MIDI clock tick
+ * 
+ * The song position is snapped to the beat grid on every beat (24 ticks). The tempo is re-estimated once per beat
+ * from the number of blocks between two beats
+ * @param state Struct holding transport clock state
+ */
+void updateTransportMIDIClock(TransportState * const state)
+{
+    if (state->clockTick == 0)
+    {
+        // Re-estimate tempo from the length of the last beat (not possible for the first beat after reset)
+        if (state->beat && state->blockCount)
+        {
+            // One beat in Q16.16 format per blockCount blocks (rounded)
+            state->increment = ((1UL << 16) + (state->blockCount >> 1)) / state->blockCount;
+            state->blocksPerBeat = (uint32_t) state->blockCount << 16;
+        }
+
+        // Snap song position to beat grid
+        state->phase = (uint32_t) state->beat << 16;
+        state->beat++;
+        state->blockCount = 0;
+    }
+
+    if (++state->clockTick >= TRANSPORT_MIDI_CLOCKS_PER_BEAT)
+    {
+        state->clockTick = 0;
+    }
+}